@@ -0,0 +1,618 @@
+/*File: ART.cpp
+ *Project: Search Engine
+ *this file contains the functionality of ART.h
+ */
+
+#include "ART.h"
+#include <stdint.h>
+#include <string.h>
+#include <limits.h>
+
+#if defined (__SSE2__) || defined (_M_X64)
+	#include <emmintrin.h>
+	#define ART_SSE2
+#endif
+
+using namespace std;
+
+static int firstBit(unsigned int bits)
+{
+	#if defined (__GNUC__) || defined (__clang__)
+		return __builtin_ctz(bits);
+	#else
+		int bit = 0;
+		while (((bits >> bit) & 1) == 0)
+			bit++;
+		return bit;
+	#endif
+}
+
+//keeps keys[0, count) in order, room for one more is left by the caller
+static void insertSorted(unsigned char* keys, void** children, int count, unsigned char letter, void* child)
+{
+	int i = count;
+	while (i > 0 && keys[i - 1] > letter)
+	{
+		keys[i] = keys[i - 1];
+		children[i] = children[i - 1];
+		i--;
+	}
+	keys[i] = letter;
+	children[i] = child;
+}
+
+static void removeSorted(unsigned char* keys, void** children, int count, unsigned char letter)
+{
+	int i = 0;
+	while (keys[i] != letter)
+		i++;
+	for (; i < count - 1; i++)
+	{
+		keys[i] = keys[i + 1];
+		children[i] = children[i + 1];
+	}
+}
+
+ART::ART()
+{
+	root = NULL;
+	size = 0;
+}
+
+ART::~ART()
+{
+	releaseWords();
+	destroy(root);
+}
+
+bool ART::isWord(void* child)
+{
+	return ((uintptr_t)child & 1) != 0;
+}
+
+Word* ART::asWord(void* child)
+{
+	return (Word*)((uintptr_t)child & ~(uintptr_t)1);
+}
+
+void* ART::fromWord(Word* word)
+{
+	return (void*)((uintptr_t)word | 1);
+}
+
+int ART::matchPrefix(Node* node, string_view key, int depth)
+{
+	int i = 0;
+	while (i < node->prefixLength && depth + i < key.size() && node->prefix[i] == (unsigned char)key[depth + i])
+		i++;
+	return i;
+}
+
+void** ART::findChild(Node* node, unsigned char letter)
+{
+	switch (node->type)
+	{
+	case NODE4:
+	{
+		Node4* small = (Node4*)node;
+		for (int i = 0; i < small->count; i++)
+			if (small->keys[i] == letter)
+				return &small->children[i];
+		return NULL;
+	}
+	case NODE16:
+	{
+		Node16* medium = (Node16*)node;
+		#if defined (ART_SSE2)
+			__m128i keys = _mm_loadu_si128((const __m128i*)medium->keys);
+			unsigned int bits = _mm_movemask_epi8(_mm_cmpeq_epi8(keys, _mm_set1_epi8(letter))) & ((1U << medium->count) - 1);
+			return bits == 0 ? NULL : &medium->children[firstBit(bits)];
+		#else
+			for (int i = 0; i < medium->count; i++)
+				if (medium->keys[i] == letter)
+					return &medium->children[i];
+			return NULL;
+		#endif
+	}
+	case NODE48:
+	{
+		Node48* large = (Node48*)node;
+		return large->slots[letter] == 0 ? NULL : &large->children[large->slots[letter] - 1];
+	}
+	default:
+	{
+		Node256* full = (Node256*)node;
+		return full->children[letter] == NULL ? NULL : &full->children[letter];
+	}
+	}
+}
+
+ART::Node* ART::newNode(int type)
+{
+	Node* node;
+	if (type == NODE4)
+		node = new Node4();
+	else if (type == NODE16)
+		node = new Node16();
+	else if (type == NODE48)
+		node = new Node48();
+	else
+		node = new Node256();
+	node->type = type;
+	return node;
+}
+
+/*
+ *a full node is copied into one of the next size, which keeps its prefix and terminal word, and the
+ *letter is added to that. nodes only grow, a node that loses children keeps its size until it is cleared
+ */
+void ART::addChild(void*& child, unsigned char letter, void* newChild)
+{
+	Node* node = (Node*)child;
+	switch (node->type)
+	{
+	case NODE4:
+	{
+		Node4* small = (Node4*)node;
+		if (small->count < 4)
+		{
+			insertSorted(small->keys, small->children, small->count, letter, newChild);
+			small->count++;
+			return;
+		}
+		Node16* bigger = (Node16*)newNode(NODE16);
+		*(Node*)bigger = *node;
+		bigger->type = NODE16;
+		memcpy(bigger->keys, small->keys, sizeof(small->keys));
+		memcpy(bigger->children, small->children, sizeof(small->children));
+		delete small;
+		child = bigger;
+		break;
+	}
+	case NODE16:
+	{
+		Node16* medium = (Node16*)node;
+		if (medium->count < 16)
+		{
+			insertSorted(medium->keys, medium->children, medium->count, letter, newChild);
+			medium->count++;
+			return;
+		}
+		Node48* bigger = (Node48*)newNode(NODE48);
+		*(Node*)bigger = *node;
+		bigger->type = NODE48;
+		for (int i = 0; i < 16; i++)
+		{
+			bigger->slots[medium->keys[i]] = i + 1;
+			bigger->children[i] = medium->children[i];
+		}
+		delete medium;
+		child = bigger;
+		break;
+	}
+	case NODE48:
+	{
+		Node48* large = (Node48*)node;
+		if (large->count < 48)
+		{
+			large->children[large->count] = newChild;
+			large->slots[letter] = large->count + 1;
+			large->count++;
+			return;
+		}
+		Node256* bigger = (Node256*)newNode(NODE256);
+		*(Node*)bigger = *node;
+		bigger->type = NODE256;
+		for (int i = 0; i < 256; i++)
+			if (large->slots[i] != 0)
+				bigger->children[i] = large->children[large->slots[i] - 1];
+		delete large;
+		child = bigger;
+		break;
+	}
+	default:
+	{
+		Node256* full = (Node256*)node;
+		full->children[letter] = newChild;
+		full->count++;
+		return;
+	}
+	}
+	addChild(child, letter, newChild);
+}
+
+//a node of 48 keeps its children at the front of the array, the last one moves into the gap
+void ART::removeChild(Node* node, unsigned char letter)
+{
+	switch (node->type)
+	{
+	case NODE4:
+		removeSorted(((Node4*)node)->keys, ((Node4*)node)->children, node->count, letter);
+		break;
+	case NODE16:
+		removeSorted(((Node16*)node)->keys, ((Node16*)node)->children, node->count, letter);
+		break;
+	case NODE48:
+	{
+		Node48* large = (Node48*)node;
+		int gap = large->slots[letter] - 1;
+		large->slots[letter] = 0;
+		if (gap != large->count - 1)
+		{
+			for (int i = 0; i < 256; i++)
+				if (large->slots[i] == large->count)
+				{
+					large->slots[i] = gap + 1;
+					break;
+				}
+			large->children[gap] = large->children[large->count - 1];
+		}
+		break;
+	}
+	default:
+		((Node256*)node)->children[letter] = NULL;
+		break;
+	}
+	node->count--;
+}
+
+Word* ART::find(string_view lookup)
+{
+	void* child = root;
+	int depth = 0;
+	while (child != NULL && !isWord(child))
+	{
+		Node* node = (Node*)child;
+		if (matchPrefix(node, lookup, depth) != node->prefixLength)
+			return NULL;
+		depth += node->prefixLength;
+		if (depth == lookup.size())
+			return node->terminal;
+		void** next = findChild(node, lookup[depth]);
+		if (next == NULL)
+			return NULL;
+		child = *next;
+		depth++;
+	}
+	if (child == NULL || asWord(child)->getKey() != lookup)	//the letters below the word's node weren't checked yet
+		return NULL;
+	return asWord(child);
+}
+
+void ART::findPrefix(string_view prefix, vector<Word*>& words, int limit)
+{
+	void* child = root;
+	int depth = 0;
+	while (child != NULL && !isWord(child))
+	{
+		Node* node = (Node*)child;
+		int matched = matchPrefix(node, prefix, depth);
+		if (depth + matched == prefix.size())	//the prefix ends within the node's letters, every word below starts with it
+		{
+			collect(child, words, limit);
+			return;
+		}
+		if (matched < node->prefixLength)
+			return;
+		depth += node->prefixLength;
+		void** next = findChild(node, prefix[depth]);
+		if (next == NULL)
+			return;
+		child = *next;
+		depth++;
+	}
+	if (child != NULL && words.size() < limit && asWord(child)->getKey().compare(0, prefix.size(), prefix) == 0)
+		words.push_back(asWord(child));
+}
+
+void ART::insert(Word* newWord)
+{
+	invalidateDictionary();
+	insert(root, newWord, newWord->getKey(), 0);
+}
+
+//adds the word below child, the first depth letters of key led to it
+void ART::insert(void*& child, Word* newWord, string_view key, int depth)
+{
+	if (child == NULL)
+	{
+		child = fromWord(newWord);
+		size++;
+		return;
+	}
+
+	if (isWord(child))	//a node for the letters both words share from depth takes the old word's place
+	{
+		Word* word = asWord(child);
+		string_view other = word->getKey();
+		if (other == key)
+		{
+			mergeWord(word, newWord);
+			return;
+		}
+		Node4* node = (Node4*)newNode(NODE4);
+		int shared = 0;
+		while (shared < MAX_PREFIX && depth + shared < key.size() && depth + shared < other.size() && key[depth + shared] == other[depth + shared])
+		{
+			node->prefix[shared] = key[depth + shared];
+			shared++;
+		}
+		node->prefixLength = shared;
+		if (depth + shared == other.size())
+			node->terminal = word;
+		else
+		{
+			node->keys[0] = other[depth + shared];
+			node->children[0] = child;
+			node->count = 1;
+		}
+		child = node;
+		insert(child, newWord, key, depth);	//the node has room for the new word beside the old one
+		return;
+	}
+
+	Node* node = (Node*)child;
+	int matched = matchPrefix(node, key, depth);
+	if (matched < node->prefixLength)	//the key leaves the prefix, a node above branches where they differ
+	{
+		Node4* top = (Node4*)newNode(NODE4);
+		top->prefixLength = matched;
+		memcpy(top->prefix, node->prefix, matched);
+		top->keys[0] = node->prefix[matched];
+		top->children[0] = node;
+		top->count = 1;
+		node->prefixLength -= matched + 1;
+		memmove(node->prefix, node->prefix + matched + 1, node->prefixLength);
+		child = top;
+		insert(child, newWord, key, depth);
+		return;
+	}
+
+	depth += node->prefixLength;
+	if (depth == key.size())
+	{
+		if (node->terminal != NULL)
+			mergeWord(node->terminal, newWord);
+		else
+		{
+			node->terminal = newWord;
+			size++;
+		}
+		return;
+	}
+	void** next = findChild(node, key[depth]);
+	if (next != NULL)
+		insert(*next, newWord, key, depth + 1);
+	else
+	{
+		addChild(child, key[depth], fromWord(newWord));
+		size++;
+	}
+}
+
+/*
+ *the letters the first and last words share are shared by every word between them, which are the
+ *node's prefix. only the first word can end there, it is the terminal word, and the rest are split
+ *into runs by their next letter, each run a child. every node is made at the size its letters need
+ */
+void* ART::build(vector<Word*>& words, int first, int last, int depth)
+{
+	if (last - first == 1)
+		return fromWord(words[first]);
+
+	string_view low = words[first]->getKey();
+	string_view high = words[last - 1]->getKey();
+	int shared = 0;
+	while (shared < MAX_PREFIX && depth + shared < low.size() && depth + shared < high.size() && low[depth + shared] == high[depth + shared])
+		shared++;
+	int below = depth + shared;
+	int start = first;
+	if (low.size() == below)
+		start++;
+
+	int letters = 0;
+	for (int i = start; i < last; i++)
+		if (i == start || words[i]->getKey()[below] != words[i - 1]->getKey()[below])
+			letters++;
+	void* child = newNode(letters <= 4 ? NODE4 : letters <= 16 ? NODE16 : letters <= 48 ? NODE48 : NODE256);
+	Node* node = (Node*)child;
+	node->prefixLength = shared;
+	memcpy(node->prefix, low.data() + depth, shared);
+	if (start > first)
+		node->terminal = words[first];
+
+	for (int i = start; i < last; )
+	{
+		unsigned char letter = words[i]->getKey()[below];
+		int j = i + 1;
+		while (j < last && (unsigned char)words[j]->getKey()[below] == letter)
+			j++;
+		addChild(child, letter, build(words, i, j, below + 1));	//in letter order, nothing moves over
+		i = j;
+	}
+	return child;
+}
+
+void ART::bulkLoad(vector<Word*>& words)
+{
+	if (size != 0)
+	{
+		FileIndex::bulkLoad(words);
+		return;
+	}
+	invalidateDictionary();
+	if (words.empty())
+		return;
+	root = build(words, 0, words.size(), 0);
+	size = words.size();
+}
+
+//takes the word out of the node it hangs from and ends it. nodes are not shrunk or merged back together,
+//they still lead to the right words and only hold letters of their own, not the words' text
+void ART::del(Word* deleteValue)
+{
+	invalidateDictionary();
+	string_view key = deleteValue->getKey();
+	void* child = root;
+	Node* parent = NULL;
+	int depth = 0;
+	while (child != NULL && !isWord(child))
+	{
+		Node* node = (Node*)child;
+		if (matchPrefix(node, key, depth) != node->prefixLength)
+			break;
+		depth += node->prefixLength;
+		if (depth == key.size())
+		{
+			if (node->terminal == NULL)
+				break;
+			Word* word = node->terminal;
+			node->terminal = NULL;
+			size--;
+			destroyWord(word);
+			return;
+		}
+		void** next = findChild(node, key[depth]);
+		if (next == NULL)
+			break;
+		parent = node;
+		child = *next;
+		depth++;
+	}
+	if (child == NULL || !isWord(child) || asWord(child)->getKey() != key)
+	{
+		cout << "element not found" << endl;
+		return;
+	}
+	Word* word = asWord(child);
+	if (parent == NULL)
+		root = NULL;
+	else
+		removeChild(parent, key[depth - 1]);	//before the word goes, key views its text
+	size--;
+	destroyWord(word);
+}
+
+int ART::nonodes()
+{
+	return size;
+}
+
+int ART::bytes()
+{
+	return bytes(root);
+}
+
+int ART::bytes(void* child)
+{
+	if (child == NULL || isWord(child))
+		return 0;
+	Node* node = (Node*)child;
+	int total = node->type == NODE4 ? sizeof(Node4) : node->type == NODE16 ? sizeof(Node16) : node->type == NODE48 ? sizeof(Node48) : sizeof(Node256);
+	for (int i = 0; i < 256; i++)
+	{
+		void** next = findChild(node, i);
+		if (next != NULL)
+			total += bytes(*next);
+	}
+	return total;
+}
+
+void ART::clear()
+{
+	getDocuments().clear();
+	releaseWords();
+	destroy(root);
+	root = NULL;
+	size = 0;
+}
+
+void ART::destroy(void* child)
+{
+	if (child == NULL || isWord(child))
+		return;
+	Node* node = (Node*)child;
+	for (int i = 0; i < 256; i++)
+	{
+		void** next = findChild(node, i);
+		if (next != NULL)
+			destroy(*next);
+	}
+	if (node->type == NODE4)
+		delete (Node4*)node;
+	else if (node->type == NODE16)
+		delete (Node16*)node;
+	else if (node->type == NODE48)
+		delete (Node48*)node;
+	else
+		delete (Node256*)node;
+}
+
+void ART::collect(void* child, vector<Word*>& words, int limit)
+{
+	if (child == NULL || words.size() >= limit)
+		return;
+	if (isWord(child))
+	{
+		words.push_back(asWord(child));
+		return;
+	}
+	Node* node = (Node*)child;
+	if (node->terminal != NULL)	//a word sorts before the longer words it starts
+		words.push_back(node->terminal);
+	switch (node->type)
+	{
+	case NODE4:
+		for (int i = 0; i < node->count; i++)
+			collect(((Node4*)node)->children[i], words, limit);
+		break;
+	case NODE16:
+		for (int i = 0; i < node->count; i++)
+			collect(((Node16*)node)->children[i], words, limit);
+		break;
+	case NODE48:
+		for (int i = 0; i < 256; i++)
+			if (((Node48*)node)->slots[i] != 0)
+				collect(((Node48*)node)->children[((Node48*)node)->slots[i] - 1], words, limit);
+		break;
+	default:
+		for (int i = 0; i < 256; i++)
+			collect(((Node256*)node)->children[i], words, limit);
+		break;
+	}
+}
+
+void ART::getWords(vector<Word*>& words)
+{
+	collect(root, words, INT_MAX);
+}
+
+void ART::printValues(int)
+{
+	vector<Word*> words;
+	getWords(words);
+	for (int j = 0; j < words.size(); j++)
+		cout << words[j]->getKey() << "-->";
+	cout << endl;
+}
+
+void ART::writeToFile(string fileName)
+{
+	ofstream outFile;
+	outFile.open(fileName.c_str());
+	if (!outFile.is_open())
+	{
+		cout << "file not found" << endl;
+	}
+	else
+	{
+		writeHeader(outFile);
+		vector<Word*> words;
+		getWords(words);
+		for (int i = 0; i < words.size(); i++)
+			words[i]->write(outFile, storesPositions(), storesImpacts(), &getDocuments());
+		getDocuments().writeFields(outFile);
+		outFile.close();
+		getDocuments().writeBodies(fileName + ".bodies");
+	}
+}
@@ -0,0 +1,101 @@
+/*File: ART.h
+ *Project: Search Engine
+ *this file implements an adaptive radix tree of the index's words. an inner node branches on one letter
+ *of the word and comes in four sizes, for up to 4, 16, 48 and 256 children, so the many nodes with a few
+ *children stay small and the few with many are a single array lookup. letters shared by every word below
+ *a node are kept in the node rather than as a chain of nodes with one child, and a word hangs from the
+ *first node where its letters tell it apart from the rest, so a lookup reads a node or two per word
+ *and its words come out in sorted order for prefix searches and for writing the index
+ */
+
+#ifndef ART_H
+#define ART_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fstream>
+#include "Word.h"
+#include "FileIndex.h"
+
+using namespace std;
+
+class ART : public FileIndex
+{
+public:
+	ART();
+	~ART();
+
+	void insert(Word* newWord);	//a word that is already in the tree takes the new word's files, see FileIndex::insert
+	void printValues(int i);
+	void del(Word* deleteValue);
+	Word* find(string_view lookup);
+	void findPrefix(string_view prefix, vector<Word*>& words, int limit);	//walks the subtree under the prefix, no dictionary is needed
+	int nonodes();
+	void clear();
+	void writeToFile(string fileName);
+	void getWords(vector<Word*>& words);	//in sorted order
+	void bulkLoad(vector<Word*>& words);	//each node is built once, at the size its children need
+	int bytes();	//size of the inner nodes, the words hang from them directly
+
+	static const int MAX_PREFIX = 10;	//shared letters kept in a node, a longer run goes on in a node below it with one child
+
+private:
+	enum Type { NODE4, NODE16, NODE48, NODE256 };
+
+	/*
+	 *a child is either a node or a word, told apart by the lowest bit of the pointer, which is set for
+	 *words. a node's prefix is the letters every word below it has after the letter that led to the node,
+	 *and terminal is the word that ends right after them, "run" in the node that also holds "runner"
+	 */
+	struct Node
+	{
+		unsigned char type;
+		unsigned char prefixLength;
+		unsigned short count;	//children, the terminal word is not counted
+		unsigned char prefix[MAX_PREFIX];
+		Word* terminal;
+	};
+
+	struct Node4 : Node	//a whole node fits in one cache line
+	{
+		unsigned char keys[4];	//in order
+		void* children[4];
+	};
+
+	struct Node16 : Node
+	{
+		unsigned char keys[16];	//in order, one SSE2 compare finds a letter among them
+		void* children[16];
+	};
+
+	struct Node48 : Node
+	{
+		unsigned char slots[256];	//one more than the position in children of each letter's child, 0 for none
+		void* children[48];
+	};
+
+	struct Node256 : Node
+	{
+		void* children[256];	//by letter, NULL for none
+	};
+
+	static bool isWord(void* child);
+	static Word* asWord(void* child);
+	static void* fromWord(Word* word);
+	static int matchPrefix(Node* node, string_view key, int depth);	//how many letters of the node's prefix key has from depth
+	static void** findChild(Node* node, unsigned char letter);	//NULL when the node has no child for the letter
+	static void removeChild(Node* node, unsigned char letter);
+	Node* newNode(int type);
+	void addChild(void*& child, unsigned char letter, void* newChild);	//child is the node, moved into the next size up when it is full
+	void insert(void*& child, Word* newWord, string_view key, int depth);
+	void* build(vector<Word*>& words, int first, int last, int depth);	//the subtree of words[first, last), which share their first depth letters
+	void collect(void* child, vector<Word*>& words, int limit);	//appends the words under child in sorted order
+	void destroy(void* child);
+	int bytes(void* child);
+
+	void* root;
+	int size;
+};
+
+#endif
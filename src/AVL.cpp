@@ -18,6 +18,7 @@ AVL::AVL(const AVL& orig) {
 }
 
 AVL::~AVL() {
+    releaseWords();
     makeempty(root_);
 }
 
@@ -32,7 +33,7 @@ void AVL::insert(Word* x,node* &p)
 {
    if (p == NULL)
    {
-	p = new node;
+	p = new (getArena().allocate(sizeof(node))) node;
 	p->element_ = x;
 	p->left_ = NULL;
 	p->right_ = NULL;
@@ -41,53 +42,101 @@ void AVL::insert(Word* x,node* &p)
    }
    else
    {
-	if (x->getWord()<p->element_->getWord())
+	if (x->getKey()<p->element_->getKey())
 	{
             insert(x,p->left_);
             if ((bsheight(p->left_) - bsheight(p->right_))==2)
             {
-                if (x->getWord() < p->left_->element_->getWord())
+                if (x->getKey() < p->left_->element_->getKey())
                     p = srl(p);
                 else
                     p = drl(p);
             }
 	}
-	else if (x->getWord() > p->element_->getWord())
+	else if (x->getKey() > p->element_->getKey())
 	{
             insert(x,p->right_);
             if ((bsheight(p->right_) - bsheight(p->left_))==2)
             {
-                if (x->getWord() > p->right_->element_->getWord())
+                if (x->getKey() > p->right_->element_->getKey())
                     p = srr(p);
                 else
                     p = drr(p);
             }
 	}
-        else 
-		{
-			vector<Word::File*> xFiles = x->getRanking();
-			for (int i = 0; i < xFiles.size(); i++)
-			{
-				p->element_->getRanking().push_back(xFiles[i]);
-			}
-		}
+        else
+            mergeWord(p->element_, x);
     }
     p->height_ = max(bsheight(p->left_),bsheight(p->right_)) + 1;
 }
 
 //		Finding an element
-Word* AVL::find(string x,node* p)
+//		one comparison of the key per node, against the word's own text
+Word* AVL::find(string_view x,node* p)
 {
     if (p==NULL)
         return NULL;
-    else if (x < p->element_->getWord())
+    int order = x.compare(p->element_->getKey());
+    if (order < 0)
         return find(x,p->left_);
-    else if (x > p->element_->getWord())
+    else if (order > 0)
         return find(x,p->right_);
     else
         return p->element_;
 }
 
+//		Finding every element starting with a prefix, in order
+//		only the subtrees that can hold the prefix are visited
+void AVL::findPrefix(string_view prefix, node* p, vector<Word*>& words, int limit)
+{
+    if (p==NULL || words.size() >= limit)
+        return;
+    const string& x = p->element_->getKey();
+    bool matches = x.compare(0, prefix.size(), prefix) == 0;
+    if (x >= prefix)
+        findPrefix(prefix, p->left_, words, limit);
+    if (matches && words.size() < limit)
+        words.push_back(p->element_);
+    if (x < prefix || matches)
+        findPrefix(prefix, p->right_, words, limit);
+}
+
+//		Collecting every element
+void AVL::getWords(node* p, vector<Word*>& words)
+{
+    if (p!=NULL)
+    {
+        getWords(p->left_, words);
+        words.push_back(p->element_);
+        getWords(p->right_, words);
+    }
+}
+
+//		Building a tree from sorted words
+//		each subtree's root is the middle of its words, so no rotations are needed
+void AVL::bulkLoad(vector<Word*>& words)
+{
+    if (root_ != NULL) {
+        FileIndex::bulkLoad(words);
+        return;
+    }
+    invalidateDictionary();
+    root_ = build(words, 0, words.size());
+}
+
+node* AVL::build(vector<Word*>& words, int first, int last)
+{
+    if (first >= last)
+        return NULL;
+    int middle = first + (last - first) / 2;
+    node* p = new (getArena().allocate(sizeof(node))) node;
+    p->element_ = words[middle];
+    p->left_ = build(words, first, middle);
+    p->right_ = build(words, middle + 1, last);
+    p->height_ = max(bsheight(p->left_),bsheight(p->right_)) + 1;
+    return p;
+}
+
 //		Copy a tree
 void AVL::copy(node* const &p,node* &p1)
 {
@@ -96,15 +145,10 @@ void AVL::copy(node* const &p,node* &p1)
 }
 
 //		Make a tree empty
+//		the nodes are in the index's arena and go back with its chunks, so only the root is let go
 void AVL::makeempty(node* &p)
 {
-    if (p != NULL)
-    {
-        makeempty(p->left_);
-        makeempty(p->right_);
-        delete p;
-        p=NULL;
-    }
+    p=NULL;
 }
 
 //Used by copy to Copy the nodes
@@ -114,7 +158,7 @@ node* AVL::nodecopy(node* p)
         return p;
     else
     {
-        node* temp = new node;
+        node* temp = new (getArena().allocate(sizeof(node))) node;
         temp->element_ = p->element_;
         temp->height_ = p->height_;
         temp->left_ = nodecopy(p->left_);
@@ -124,65 +168,45 @@ node* AVL::nodecopy(node* p)
 }
 
 //Deleting a node
-void AVL::del(Word* x,node* &p)
+//the unlinked node stays in the arena until the index is cleared, the caller ends its word
+Word* AVL::del(Word* x,node* &p)
 {
-    node* d;
+    Word* removed = NULL;
     if (p==NULL)
         cout<<"element not found" << endl;
-    else if (x->getWord() < p->element_->getWord()){
-        del(x,p->left_);
-        p->height_ = max(bsheight(p->left_),bsheight(p->right_)) + 1;
-        if ((bsheight(p->right_) - bsheight(p->left_))==2)
-        {
-            if (x->getWord() > p->right_->element_->getWord())
-                p = srr(p);
-            else
-                p = drr(p);
-        }
+    else if (x->getKey() < p->element_->getKey()){
+        removed = del(x,p->left_);
+        rebalance(p);
     }
-    else if (x->getWord() > p->element_->getWord()){
-        del(x,p->right_);
-        p->height_ = max(bsheight(p->left_),bsheight(p->right_)) + 1;
-        if ((bsheight(p->left_) - bsheight(p->right_))==2)
-        {
-            if (x->getWord() < p->left_->element_->getWord())
-                p = srl(p);
-            else
-                p = drl(p);
-        }
+    else if (x->getKey() > p->element_->getKey()){
+        removed = del(x,p->right_);
+        rebalance(p);
     }
     else if ((p->left_ == NULL) && (p->right_ == NULL))
     {
-        delete p;
+        removed = p->element_;
         p=NULL;
         cout<<"element deleted!"<<endl;
     }
     else if (p->left_ == NULL)
     {
-        d=p;
+        removed = p->element_;
         p=p->right_;
-        delete d;
         cout<<"element deleted!"<<endl;
     }
     else if (p->right_ == NULL)
     {
-        d=p;
+        removed = p->element_;
         p=p->left_;
-        delete d;
         cout<<"element deleted!"<<endl;
     }
     else{
+        removed = p->element_;
         p->element_ = deletemin(p->right_);
         cout<<"element deleted!"<<endl;
-        if ((bsheight(p->left_) - bsheight(p->right_))==2)
-        {
-            if (p->left_->right_ == NULL)
-                p = srl(p);
-            else{
-                p = drl(p);
-            }
-        }
+        rebalance(p);
     }
+    return removed;
 }
 
 //used by delete when the node to be deleted has 2 children
@@ -198,24 +222,37 @@ Word* AVL::deletemin(node* &p)
     else
     {
         c=deletemin(p->left_);
-        p->height_ = max(bsheight(p->left_),bsheight(p->right_)) + 1;
-        if ((bsheight(p->right_) - bsheight(p->left_))==2)
-        {
-            if (p->right_->left_ == NULL)
-                p = srr(p);
-            else{
-                p = drr(p);
-            }
-        }
+        rebalance(p);
         return c;
     }
 }
 
+//a delete shortens one side, unlike an insert the key deleted doesn't tell which rotation fixes it. the
+//taller child is rotated up, first turned around when its inner subtree is the taller one
+void AVL::rebalance(node* &p)
+{
+    p->height_ = max(bsheight(p->left_),bsheight(p->right_)) + 1;
+    if ((bsheight(p->right_) - bsheight(p->left_))==2)
+    {
+        if (bsheight(p->right_->right_) >= bsheight(p->right_->left_))
+            p = srr(p);
+        else
+            p = drr(p);
+    }
+    else if ((bsheight(p->left_) - bsheight(p->right_))==2)
+    {
+        if (bsheight(p->left_->left_) >= bsheight(p->left_->right_))
+            p = srl(p);
+        else
+            p = drl(p);
+    }
+}
+
 void AVL::preorder(node* p)
 {
     if (p!=NULL)
     {
-        cout<<p->element_->getWord()<<"-->";
+        cout<<p->element_->getKey()<<"-->";
         preorder(p->left_);
         preorder(p->right_);
     }
@@ -227,7 +264,7 @@ void AVL::inorder(node* p)
     if (p!=NULL)
     {
         inorder(p->left_);
-        cout<<p->element_->getWord()<<" at height "<<p->height_<<"-->";
+        cout<<p->element_->getKey()<<" at height "<<p->height_<<"-->";
         inorder(p->right_);
     }
 }
@@ -239,7 +276,7 @@ void AVL::postorder(node* p)
     {
         postorder(p->left_);
         postorder(p->right_);
-        cout<<p->element_->getWord()<<"-->";
+        cout<<p->element_->getKey()<<"-->";
     }
 }
 
@@ -301,38 +338,25 @@ void AVL::writeToFile(string fileName)
 {
 	ofstream outFile;
 	outFile.open(fileName.c_str());
-	int size = nonodes();
 	if(!outFile.is_open())
 	{
 		cout << "file not found" << endl;
 	}
 	else
 	{
-		outFile<<size<<endl;
+		writeHeader(outFile);
 		writeToFile(fileName, root_, outFile);
+		getDocuments().writeFields(outFile);
 		outFile.close();
+		getDocuments().writeBodies(fileName + ".bodies");
 	}
 }
 
 void AVL::writeToFile(string fileName, node* p, ofstream& outFile){
     if (p!=NULL)
     {
-	Word* word = p->element_;
 	writeToFile(fileName, p->left_, outFile);
-	outFile << word->getWord() << endl;      //writes word to file
-	vector<Word::File*> out = word->getRanking();
-	int size = word->getTotalNumberDocuments();
-	outFile << size << endl;                      //writes number of files to document
-	for(int i = 0; i < size; i++)
-	{
-		outFile << out[i]->fileName << endl;  //writes the filename to document
-		outFile << out[i]->TFIDF << endl;      //TFIDF
-		outFile << out[i]->numberOfAppearances << endl;  //number of appearances in that particular file
-		outFile << out[i]->totalWordsInFile << endl;    //total words in the file
-		outFile << out[i]->year << endl;	// year of post
-		outFile << out[i]->strmonth << endl;	// month of post
-		outFile << out[i]->day << endl;		// day of post
-	}
+	p->element_->write(outFile, storesPositions(), storesImpacts(), &getDocuments());
 	writeToFile(fileName, p->right_, outFile);
     }
 
@@ -23,21 +23,27 @@ public:
     ~AVL();
     
     void printValues(int i);
-    void insert(Word* w) {insert(w, root_);}
-    void del(Word* w) {del(w, root_);}
-    Word* find(string w) {return find(w, root_);}
+    void insert(Word* w) {invalidateDictionary(); insert(w, root_);}
+    void del(Word* w) {invalidateDictionary(); Word* removed = del(w, root_); if (removed != NULL) destroyWord(removed);}
+    Word* find(string_view w) {return find(w, root_);}
+    void findPrefix(string_view prefix, vector<Word*>& words, int limit) {findPrefix(prefix, root_, words, limit);}
+    void getWords(vector<Word*>& words) {getWords(root_, words);}
+    void bulkLoad(vector<Word*>& words);
     void preorder() {preorder(root_); cout << endl;}
     void inorder() {inorder(root_); cout << endl;}
     void postorder() {postorder(root_); cout << endl;}
     int bsheight() {return bsheight(root_);}
     int nonodes() {int x = 0; return nonodes(root_, x);}
-    void clear() {makeempty(root_);}
+    void clear() {getDocuments().clear(); releaseWords(); makeempty(root_);}
     void writeToFile(string fileName);    
 
 private:
     void insert(Word*,node* &);
-    void del(Word*, node* &);
-    Word* find(string,node*);
+    Word* del(Word*, node* &);   //the word taken out of the tree, which still compares with it on the way up
+    Word* find(string_view,node*);
+    void findPrefix(string_view, node*, vector<Word*>&, int);
+    void getWords(node*, vector<Word*>&);
+    node* build(vector<Word*>&, int, int);
     void preorder(node*);
     void inorder(node*);
     void postorder(node*);
@@ -50,6 +56,7 @@ private:
     node* drr(node* &);
     
     Word* deletemin(node* &);
+    void rebalance(node* &);   //after a delete below p, by the heights of the taller child's subtrees
     
     void copy(node* const &,node* &);
     node* nodecopy(node*);
@@ -0,0 +1,71 @@
+/*File: Arena.cpp
+ *Project: Search Engine
+ *this file contains the functionality of Arena.h
+ */
+
+#include "Arena.h"
+#include <cstdlib>
+#include <new>
+
+using namespace std;
+
+Arena::Arena()
+{
+	next = NULL;
+	end = NULL;
+	used = 0;
+}
+
+Arena::~Arena()
+{
+	release();
+}
+
+//sizes are rounded up to the strictest alignment, so every object starts where any type may. a request
+//bigger than a quarter chunk gets a chunk of its own, which keeps the newest chunk's free space for small ones
+void* Arena::allocate(size_t size)
+{
+	const size_t align = alignof(max_align_t);
+	size = (size + align - 1) & ~(align - 1);
+	used += size;
+	if (size > CHUNK_SIZE / 4)
+	{
+		char* chunk = (char*)malloc(size);
+		if (chunk == NULL)
+			throw bad_alloc();
+		chunkList.push_back(chunk);
+		return chunk;
+	}
+	if (next == NULL || (size_t)(end - next) < size)
+	{
+		char* chunk = (char*)malloc(CHUNK_SIZE);
+		if (chunk == NULL)
+			throw bad_alloc();
+		chunkList.push_back(chunk);
+		next = chunk;
+		end = chunk + CHUNK_SIZE;
+	}
+	void* object = next;
+	next += size;
+	return object;
+}
+
+void Arena::release()
+{
+	for (int i = 0; i < chunkList.size(); i++)
+		free(chunkList[i]);
+	chunkList.clear();
+	next = NULL;
+	end = NULL;
+	used = 0;
+}
+
+size_t Arena::bytes()
+{
+	return used;
+}
+
+int Arena::chunks()
+{
+	return chunkList.size();
+}
@@ -0,0 +1,39 @@
+/*File: Arena.h
+ *Project: Search Engine
+ *this file implements a chunked bump allocator for the many small objects an index is made of, its
+ *words, their postings and tree nodes. objects are carved out of large chunks one after another and
+ *are never freed on their own, all of the chunks are given back at once when the index is cleared
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <vector>
+
+using namespace std;
+
+class Arena
+{
+public:
+	Arena();
+	~Arena();
+
+	void* allocate(size_t size);	//aligned for any type, as new would be
+	void release();	//frees every chunk, nothing allocated before may be used after this
+	size_t bytes();	//handed out since the last release
+	int chunks();
+
+	static const size_t CHUNK_SIZE = 1 << 20;
+
+private:
+	Arena(const Arena&);
+	const Arena& operator=(const Arena&);
+
+	vector<char*> chunkList;
+	char* next;	//free space of the newest chunk runs from next to end
+	char* end;
+	size_t used;
+};
+
+#endif
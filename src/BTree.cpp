@@ -0,0 +1,422 @@
+/*File: BTree.cpp
+ *Project: Search Engine
+ *this file contains the functionality of BTree.h
+ */
+
+#include "BTree.h"
+
+using namespace std;
+
+BTree::BTree()
+{
+	root = newNode(true);
+	size = 0;
+}
+
+BTree::~BTree()
+{
+	releaseWords();
+	destroy(root);
+}
+
+/*
+ *a key's letters are zero padded to sixteen bytes, which sorts correctly because words hold no zero
+ *bytes. keys with different letters there are ordered by the two numbers alone, and a key shorter than
+ *sixteen letters is equal to any key with the same numbers, so the words are only read to break ties
+ *between long keys
+ */
+BTree::Key::Key(string_view key) : text(key)
+{
+	prefix = Word::packLetters(key, 0);
+	suffix = Word::packLetters(key, 8);
+	complete = key.size() < 16;
+}
+
+int BTree::lowerBound(Node* node, const Key& key)
+{
+	int i = 0;
+	while (i < node->count && node->prefixes[i] < key.prefix)
+		i++;
+	while (i < node->count && node->prefixes[i] == key.prefix && node->suffixes[i] < key.suffix)
+		i++;
+	if (!key.complete)
+		while (i < node->count && node->prefixes[i] == key.prefix && node->suffixes[i] == key.suffix && node->words[i]->getKey() < key.text)
+			i++;
+	return i;
+}
+
+int BTree::upperBound(Node* node, const Key& key)
+{
+	int i = lowerBound(node, key);
+	if (i < node->count && matches(node, i, key))
+		i++;
+	return i;
+}
+
+bool BTree::matches(Node* node, int i, const Key& key)
+{
+	if (node->prefixes[i] != key.prefix || node->suffixes[i] != key.suffix)
+		return false;
+	return key.complete || node->words[i]->getKey() == key.text;
+}
+
+void BTree::setKey(Node* node, int i, Word* word)
+{
+	node->prefixes[i] = Word::packLetters(word->getKey(), 0);
+	node->suffixes[i] = Word::packLetters(word->getKey(), 8);
+	node->words[i] = word;
+}
+
+void BTree::moveKey(Node* from, int i, Node* to, int j)
+{
+	to->prefixes[j] = from->prefixes[i];
+	to->suffixes[j] = from->suffixes[i];
+	to->words[j] = from->words[i];
+}
+
+BTree::Node* BTree::newNode(bool leaf)
+{
+	Node* node = new Node;
+	node->count = 0;
+	node->leaf = leaf;
+	node->next = NULL;
+	for (int i = 0; i <= ORDER; i++)
+		node->children[i] = NULL;
+	return node;
+}
+
+BTree::Node* BTree::findLeaf(const Key& key)
+{
+	Node* node = root;
+	while (!node->leaf)
+		node = node->children[upperBound(node, key)];
+	return node;
+}
+
+Word* BTree::find(string_view lookup)
+{
+	Key key(lookup);
+	Node* leaf = findLeaf(key);
+	int i = lowerBound(leaf, key);
+	if (i == leaf->count || !matches(leaf, i, key))
+		return NULL;
+	return leaf->words[i];
+}
+
+void BTree::findPrefix(string_view prefix, vector<Word*>& words, int limit)
+{
+	Key key(prefix);
+	Node* leaf = findLeaf(key);
+	int i = lowerBound(leaf, key);
+	while (leaf != NULL && words.size() < limit)
+	{
+		if (i == leaf->count)
+		{
+			leaf = leaf->next;
+			i = 0;
+			continue;
+		}
+		if (leaf->words[i]->getKey().compare(0, prefix.size(), prefix) != 0)
+			return;
+		words.push_back(leaf->words[i++]);
+	}
+}
+
+void BTree::insert(Word* newWord)
+{
+	invalidateDictionary();
+	Node* right = NULL;
+	Word* separator = NULL;
+	insert(root, newWord, Key(newWord->getKey()), right, separator);
+	if (right == NULL)
+		return;
+
+	Node* top = newNode(false);	//the root split, the tree grows a level
+	top->count = 1;
+	setKey(top, 0, separator);
+	top->children[0] = root;
+	top->children[1] = right;
+	root = top;
+}
+
+//adds the word below node, when node has to split the new node to its right and the first word under it are passed back up
+void BTree::insert(Node* node, Word* newWord, const Key& key, Node*& right, Word*& separator)
+{
+	right = NULL;
+	if (node->leaf)
+	{
+		int i = lowerBound(node, key);
+		if (i < node->count && matches(node, i, key))
+		{
+			mergeWord(node->words[i], newWord);
+			return;
+		}
+		for (int j = node->count; j > i; j--)
+			moveKey(node, j - 1, node, j);
+		setKey(node, i, newWord);
+		node->count++;
+		size++;
+	}
+	else
+	{
+		int i = upperBound(node, key);
+		Node* child = NULL;
+		Word* childSeparator = NULL;
+		insert(node->children[i], newWord, key, child, childSeparator);
+		if (child == NULL)
+			return;
+		for (int j = node->count; j > i; j--)
+		{
+			moveKey(node, j - 1, node, j);
+			node->children[j + 1] = node->children[j];
+		}
+		setKey(node, i, childSeparator);
+		node->children[i + 1] = child;
+		node->count++;
+	}
+
+	if (node->count == ORDER)	//kept one short of full so the insert above always has room
+		split(node, right, separator);
+}
+
+/*
+ *a leaf keeps its first half and gives the rest to the new leaf, whose first word goes up as the
+ *separator. an inner node gives up its middle key instead, it moves up and is not kept in either half
+ */
+void BTree::split(Node* node, Node*& right, Word*& separator)
+{
+	right = newNode(node->leaf);
+	int half = node->count / 2;
+	if (node->leaf)
+	{
+		right->count = node->count - half;
+		for (int j = 0; j < right->count; j++)
+			moveKey(node, half + j, right, j);
+		node->count = half;
+		right->next = node->next;
+		node->next = right;
+		separator = right->words[0];
+		return;
+	}
+
+	separator = node->words[half];
+	right->count = node->count - half - 1;
+	for (int j = 0; j < right->count; j++)
+	{
+		moveKey(node, half + 1 + j, right, j);
+		right->children[j] = node->children[half + 1 + j];
+	}
+	right->children[right->count] = node->children[node->count];
+	node->count = half;
+}
+
+/*
+ *the words are spread evenly over as few leaves as hold them one short of full, the most an insert
+ *leaves in a node, and every level above is built the same way from the nodes below until one is
+ *left. a node's separators are the first words under each of its children but the first
+ */
+void BTree::bulkLoad(vector<Word*>& words)
+{
+	if (size != 0)
+	{
+		FileIndex::bulkLoad(words);
+		return;
+	}
+	invalidateDictionary();
+	if (words.empty())
+		return;
+	destroy(root);
+
+	vector<Node*> level;
+	vector<Word*> firsts;	//the first word under each node of level
+	int leaves = (words.size() + ORDER - 2) / (ORDER - 1);
+	for (int j = 0; j < leaves; j++)
+	{
+		int first = (long long)words.size() * j / leaves;
+		int last = (long long)words.size() * (j + 1) / leaves;
+		Node* leaf = newNode(true);
+		for (int i = first; i < last; i++)
+			setKey(leaf, i - first, words[i]);
+		leaf->count = last - first;
+		if (!level.empty())
+			level.back()->next = leaf;
+		level.push_back(leaf);
+		firsts.push_back(words[first]);
+	}
+
+	while (level.size() > 1)
+	{
+		vector<Node*> upper;
+		vector<Word*> upperFirsts;
+		int nodes = (level.size() + ORDER - 1) / ORDER;	//a node of ORDER children has ORDER - 1 keys
+		for (int j = 0; j < nodes; j++)
+		{
+			int first = (long long)level.size() * j / nodes;
+			int last = (long long)level.size() * (j + 1) / nodes;
+			Node* node = newNode(false);
+			node->children[0] = level[first];
+			for (int i = first + 1; i < last; i++)
+			{
+				setKey(node, i - first - 1, firsts[i]);
+				node->children[i - first] = level[i];
+			}
+			node->count = last - first - 1;
+			upper.push_back(node);
+			upperFirsts.push_back(firsts[first]);
+		}
+		level.swap(upper);
+		firsts.swap(upperFirsts);
+	}
+	root = level[0];
+	size = words.size();
+}
+
+//takes the word out of its leaf and ends it. leaves are not merged back together, the separators above
+//still bound the words correctly and the index only ever loses words when it is cleared
+void BTree::del(Word* deleteValue)
+{
+	invalidateDictionary();
+	Key key(deleteValue->getKey());
+	Node* leaf = findLeaf(key);
+	int i = lowerBound(leaf, key);
+	if (i == leaf->count || !matches(leaf, i, key))
+	{
+		cout << "element not found" << endl;
+		return;
+	}
+	Word* removed = leaf->words[i];
+	for (int j = i; j < leaf->count - 1; j++)
+		moveKey(leaf, j + 1, leaf, j);
+	leaf->count--;
+	size--;
+	if (size == 0)
+	{
+		destroy(root);
+		root = newNode(true);
+	}
+	else
+		replaceSeparator(removed, key);
+	destroyWord(removed);
+}
+
+/*
+ *a separator is the first word of the child to its right when it is made, and ties between long keys
+ *read its text, so one that is removed is pointed at that child's first word left. the same word can
+ *separate at each level on the way down, all of them are on the key's path. a child that deletes
+ *have emptied is taken out along with the separator, its leaves are unlinked from the chain first
+ */
+void BTree::replaceSeparator(Word* removed, const Key& key)
+{
+	Node* node = root;
+	while (!node->leaf)
+	{
+		int j = upperBound(node, key);
+		if (j > 0 && node->words[j - 1] == removed)
+		{
+			Word* first = firstWord(node->children[j]);
+			if (first == NULL)
+			{
+				Node* before = node->children[j - 1];
+				while (!before->leaf)
+					before = before->children[before->count];
+				Node* last = node->children[j];
+				while (!last->leaf)
+					last = last->children[last->count];
+				before->next = last->next;
+				destroy(node->children[j]);
+				for (int m = j - 1; m < node->count - 1; m++)
+				{
+					moveKey(node, m + 1, node, m);
+					node->children[m + 1] = node->children[m + 2];
+				}
+				node->count--;
+				return;	//the word's leaf was in the emptied child
+			}
+			setKey(node, j - 1, first);
+		}
+		node = node->children[j];
+	}
+}
+
+Word* BTree::firstWord(Node* node)
+{
+	if (node->leaf)
+		return node->count > 0 ? node->words[0] : NULL;
+	for (int i = 0; i <= node->count; i++)
+	{
+		Word* word = firstWord(node->children[i]);
+		if (word != NULL)
+			return word;
+	}
+	return NULL;
+}
+
+int BTree::nonodes()
+{
+	return size;
+}
+
+int BTree::height()
+{
+	int levels = 1;
+	for (Node* node = root; !node->leaf; node = node->children[0])
+		levels++;
+	return levels;
+}
+
+void BTree::clear()
+{
+	getDocuments().clear();
+	releaseWords();
+	destroy(root);
+	root = newNode(true);
+	size = 0;
+}
+
+void BTree::destroy(Node* node)
+{
+	if (!node->leaf)
+		for (int i = 0; i <= node->count; i++)
+			destroy(node->children[i]);
+	delete node;
+}
+
+void BTree::getWords(vector<Word*>& words)
+{
+	Node* leaf = root;
+	while (!leaf->leaf)
+		leaf = leaf->children[0];
+	for (; leaf != NULL; leaf = leaf->next)
+		for (int i = 0; i < leaf->count; i++)
+			words.push_back(leaf->words[i]);
+}
+
+void BTree::printValues(int)
+{
+	vector<Word*> words;
+	getWords(words);
+	for (int j = 0; j < words.size(); j++)
+		cout << words[j]->getKey() << "-->";
+	cout << endl;
+}
+
+void BTree::writeToFile(string fileName)
+{
+	ofstream outFile;
+	outFile.open(fileName.c_str());
+	if (!outFile.is_open())
+	{
+		cout << "file not found" << endl;
+	}
+	else
+	{
+		writeHeader(outFile);
+		vector<Word*> words;
+		getWords(words);
+		for (int i = 0; i < words.size(); i++)
+			words[i]->write(outFile, storesPositions(), storesImpacts(), &getDocuments());
+		getDocuments().writeFields(outFile);
+		outFile.close();
+		getDocuments().writeBodies(fileName + ".bodies");
+	}
+}
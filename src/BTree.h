@@ -0,0 +1,83 @@
+/*File: BTree.h
+ *Project: Search Engine
+ *this file implements a B+ tree of the index's words. its nodes are a few cache lines wide and keep the
+ *first sixteen letters of every key inline as two numbers, so a lookup compares keys without following
+ *a pointer to each word and only reads the word itself to tell apart long keys that share those letters
+ */
+
+#ifndef BTREE_H
+#define BTREE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fstream>
+#include "Word.h"
+#include "FileIndex.h"
+
+using namespace std;
+
+class BTree : public FileIndex
+{
+public:
+	BTree();
+	~BTree();
+
+	void insert(Word* newWord);	//a word that is already in the tree takes the new word's files, see FileIndex::insert
+	void printValues(int i);
+	void del(Word* deleteValue);
+	Word* find(string_view lookup);
+	void findPrefix(string_view prefix, vector<Word*>& words, int limit);	//walks the chained leaves, no dictionary is needed
+	int nonodes();
+	void clear();
+	void writeToFile(string fileName);
+	void getWords(vector<Word*>& words);	//in sorted order
+	void bulkLoad(vector<Word*>& words);	//packs the leaves, then builds each level above from the one below
+	int height();
+
+	static const int ORDER = 31;	//keys per node, the first halves of a node's keys fill four cache lines
+
+private:
+	/*
+	 *in a leaf words[i] is the i'th word. in an inner node children[i] holds the words below words[i]
+	 *and children[i + 1] those from words[i] on. prefixes[i] and suffixes[i] are letters 0-7 and 8-15
+	 *of words[i]->getKey(), the suffixes are only read when the prefixes are equal
+	 */
+	struct alignas(64) Node
+	{
+		unsigned long long prefixes[ORDER];
+		unsigned long long suffixes[ORDER];
+		Word* words[ORDER];
+		Node* children[ORDER + 1];
+		Node* next;	//the leaf after this one, NULL for inner nodes and the last leaf
+		int count;
+		bool leaf;
+	};
+
+	struct Key
+	{
+		Key(string_view key);
+		unsigned long long prefix;
+		unsigned long long suffix;
+		string_view text;
+		bool complete;	//shorter than sixteen letters, so the numbers alone decide every comparison
+	};
+
+	static int lowerBound(Node* node, const Key& key);	//first key not less than key
+	static int upperBound(Node* node, const Key& key);	//first key greater than key
+	static bool matches(Node* node, int i, const Key& key);
+	static void setKey(Node* node, int i, Word* word);
+	static void moveKey(Node* from, int i, Node* to, int j);
+	Node* newNode(bool leaf);
+	Node* findLeaf(const Key& key);
+	void insert(Node* node, Word* newWord, const Key& key, Node*& split, Word*& separator);
+	void split(Node* node, Node*& right, Word*& separator);
+	void destroy(Node* node);
+	void replaceSeparator(Word* removed, const Key& key);	//leaves no separator pointing at a word deleted from the tree
+	static Word* firstWord(Node* node);	//NULL when deletes have emptied every leaf below node
+
+	Node* root;
+	int size;
+};
+
+#endif
@@ -0,0 +1,323 @@
+/*File: BackendBench.cpp
+ *Project: Search Engine
+ *this file compares the index structures with numbers instead of a session switching between them.
+ *each structure is built by inserting the words one at a time, then loaded again in bulk, then has
+ *words that are in it and words that aren't looked up, and is then deleted. the times of all of these,
+ *the lookup latencies and the peak resident memory go to a JSON report, and a summary to the screen
+ *
+ *usage: BackendBench [number of words] [lookups] [report file] [index file]
+ *the report is written to BackendBench.json unless another file is named. with an index file its words
+ *are used instead of made up ones, and the bulk load reads the whole index, postings and all, the way
+ *oUSE loads it. where processes can be forked each structure runs in a process of its own, so its peak
+ *memory isn't the peak of a structure before it
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <set>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <stdlib.h>
+#include "FileIndex.h"
+#include "SecondaryParser.h"
+#include <fstream>
+#include <sstream>
+
+#if defined (__GLIBC__)
+	#include <malloc.h>
+#endif
+#if !defined (_MSC_VER)
+	#include <sys/resource.h>
+	#include <sys/wait.h>
+	#include <unistd.h>
+#endif
+
+using namespace std;
+
+static const int BATCH = 64;	//lookups timed together, one clock read per lookup would cost more than many lookups
+
+vector<string> madeUpWords(int count, mt19937& random)
+{
+	set<string> words;
+	uniform_int_distribution<int> length(3, 12);
+	uniform_int_distribution<int> letter('a', 'z');
+	while (words.size() < count)
+	{
+		string word(length(random), ' ');
+		for (int i = 0; i < word.size(); i++)
+			word[i] = letter(random);
+		words.insert(word);
+	}
+	return vector<string>(words.begin(), words.end());
+}
+
+// made up words that aren't among words, which is sorted
+vector<string> missingWords(int count, const vector<string>& words, mt19937& random)
+{
+	vector<string> missing;
+	while (missing.size() < count)
+	{
+		vector<string> made = madeUpWords(min(count - (int)missing.size(), 100000), random);
+		for (int i = 0; i < made.size(); i++)
+			if (!binary_search(words.begin(), words.end(), made[i]))
+				missing.push_back(made[i]);
+	}
+	return missing;
+}
+
+vector<string> indexWords(string fileName)
+{
+	FileIndex* index = FileIndex::create("HashMap");
+	SecondaryParser parser(index);
+	parser.parseFile(fileName);
+	vector<Word*> words;
+	index->getWords(words);
+	vector<string> names;
+	for (int i = 0; i < words.size(); i++)
+		names.push_back(words[i]->getWord());
+	delete index;
+	return names;
+}
+
+// the most this process has had resident so far in kilobytes, -1 where it can't be read
+long long peakResident()
+{
+	#if !defined (_MSC_VER)
+		struct rusage usage;
+		if (getrusage(RUSAGE_SELF, &usage) != 0)
+			return -1;
+		#if defined (__APPLE__)
+			return usage.ru_maxrss / 1024;	//bytes there, kilobytes on linux
+		#else
+			return usage.ru_maxrss;
+		#endif
+	#else
+		return -1;
+	#endif
+}
+
+double millisecondsSince(chrono::steady_clock::time_point start)
+{
+	return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+string jsonString(string text)
+{
+	string quoted = "\"";
+	for (int i = 0; i < text.size(); i++)
+	{
+		if (text[i] == '"' || text[i] == '\\')
+			quoted += '\\';
+		quoted += text[i];
+	}
+	return quoted + "\"";
+}
+
+string jsonCount(long long count)
+{
+	return count < 0 ? "null" : to_string(count);
+}
+
+// looks up every key, BATCH at a time, and writes the mean, median and 99th percentile ns a lookup to report
+int timeLookups(FileIndex* index, const vector<string>& keys, ostream& report, double& mean)
+{
+	int found = 0;
+	vector<double> batches;
+	double total = 0;
+	for (int i = 0; i < keys.size(); i += BATCH)
+	{
+		int end = min(i + BATCH, (int)keys.size());
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		for (int j = i; j < end; j++)
+			found += index->find(keys[j]) != NULL;
+		double time = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+		total += time;
+		batches.push_back(time / (end - i));
+	}
+	mean = keys.empty() ? 0 : total / keys.size();
+	sort(batches.begin(), batches.end());
+	report << "{\"mean_ns\": " << mean;
+	report << ", \"p50_ns\": " << (batches.empty() ? 0 : batches[batches.size() / 2]);
+	report << ", \"p99_ns\": " << (batches.empty() ? 0 : batches[batches.size() * 99 / 100]);
+	report << ", \"found\": " << found << "}";
+	return found;
+}
+
+/*
+ *words is sorted, order holds the same words shuffled for the inserts. the words are made before the
+ *clock starts, so only the structure is timed, and one lookup ends each build, so a structure that
+ *builds its lookup on first use, like PerfectHashMap, builds it while it is timed
+ */
+string runBackend(string type, const vector<string>& words, const vector<string>& order, const vector<string>& hits,
+	const vector<string>& misses, string indexFile)
+{
+	ostringstream report;
+	report << fixed << setprecision(3);
+	long long residentBefore = peakResident();
+
+	FileIndex* index = FileIndex::create(type);
+	vector<Word*> newWords(order.size());
+	for (int i = 0; i < order.size(); i++)
+		newWords[i] = index->newWord(order[i]);
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	for (int i = 0; i < newWords.size(); i++)
+		index->insert(newWords[i]);
+	if (!order.empty())
+		index->find(order[0]);
+	double buildTime = millisecondsSince(start);
+	delete index;
+
+	index = FileIndex::create(type);
+	if (indexFile != "")
+	{
+		SecondaryParser parser(index);
+		start = chrono::steady_clock::now();
+		parser.parseFile(indexFile);
+	}
+	else
+	{
+		for (int i = 0; i < words.size(); i++)
+			newWords[i] = index->newWord(words[i]);
+		start = chrono::steady_clock::now();
+		index->bulkLoad(newWords);
+	}
+	if (!words.empty())
+		index->find(words[0]);
+	double bulkLoadTime = millisecondsSince(start);
+	int loaded = index->nonodes();
+
+	report << "{\"name\": " << jsonString(type);
+	report << ", \"words\": " << loaded;
+	report << ", \"build_ms\": " << buildTime;
+	report << ", \"bulk_load_ms\": " << bulkLoadTime;
+	double hitTime, missTime;
+	report << ", \"hit_lookup\": ";
+	int found = timeLookups(index, hits, report, hitTime);
+	report << ", \"miss_lookup\": ";
+	int falseHits = timeLookups(index, misses, report, missTime);
+
+	start = chrono::steady_clock::now();
+	delete index;	//the words go with it
+	double teardownTime = millisecondsSince(start);
+	long long residentPeak = peakResident();
+	report << ", \"teardown_ms\": " << teardownTime;
+	report << ", \"resident_before_kb\": " << jsonCount(residentBefore);
+	report << ", \"peak_resident_kb\": " << jsonCount(residentPeak) << "}";
+
+	cout << setw(16) << type << fixed << setprecision(1) << setw(12) << buildTime << setw(12) << bulkLoadTime
+		<< setw(12) << hitTime << setw(12) << missTime << setw(12) << teardownTime;
+	if (residentPeak < 0)
+		cout << setw(12) << "n/a" << endl;
+	else
+		cout << setw(12) << (residentPeak - residentBefore) / 1024.0 << endl;
+	if (loaded != words.size() || found != hits.size() || falseHits != 0)
+		cout << "  " << loaded << " words loaded, " << found << " of " << hits.size() << " words found, "
+			<< falseHits << " missing words found" << endl;
+	return report.str();
+}
+
+// runs the structure in a child process where there are processes, so its peak memory is its own
+string runIsolated(string type, const vector<string>& words, const vector<string>& order, const vector<string>& hits,
+	const vector<string>& misses, string indexFile)
+{
+	#if defined (__GLIBC__)
+		malloc_trim(0);	//freed heap the child would fill without its resident memory growing is given back first
+	#endif
+	#if !defined (_MSC_VER)
+		cout.flush();
+		int channel[2];
+		if (pipe(channel) != 0)
+			return runBackend(type, words, order, hits, misses, indexFile);
+		pid_t child = fork();
+		if (child == 0)
+		{
+			close(channel[0]);
+			string report = runBackend(type, words, order, hits, misses, indexFile);
+			cout.flush();
+			bool written = write(channel[1], report.c_str(), report.size()) == report.size();
+			close(channel[1]);
+			_exit(written ? 0 : 1);
+		}
+		close(channel[1]);
+		string report;
+		char buffer[4096];
+		int length;
+		while (child > 0 && (length = read(channel[0], buffer, sizeof(buffer))) > 0)
+			report.append(buffer, length);
+		close(channel[0]);
+		int status = 0;
+		if (child < 0 || waitpid(child, &status, 0) != child || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+		{
+			cout << setw(16) << type << "  failed" << endl;
+			return "{\"name\": " + jsonString(type) + ", \"error\": \"the benchmark process failed\"}";
+		}
+		return report;
+	#else
+		return runBackend(type, words, order, hits, misses, indexFile);
+	#endif
+}
+
+int main(int argc, char* argv[])
+{
+	int numberOfWords = 200000;
+	int lookups = 1000000;
+	string reportFile = "BackendBench.json";
+	string indexFile = "";
+	if (argc > 1)
+		numberOfWords = atoi(argv[1]);
+	if (argc > 2)
+		lookups = atoi(argv[2]);
+	if (argc > 3)
+		reportFile = argv[3];
+	if (argc > 4)
+		indexFile = argv[4];
+
+	ofstream out(reportFile.c_str());	//opened first, so a report that can't be written doesn't wait for every structure
+	if (!out.is_open())
+	{
+		cerr << "the report could not be written to " << reportFile << endl;
+		return 1;
+	}
+
+	mt19937 random(42);
+	vector<string> words = indexFile != "" ? indexWords(indexFile) : madeUpWords(numberOfWords, random);
+	sort(words.begin(), words.end());
+	vector<string> order = words;
+	shuffle(order.begin(), order.end(), random);
+	vector<string> hits;
+	if (!words.empty())
+	{
+		uniform_int_distribution<int> pick(0, words.size() - 1);
+		for (int i = 0; i < lookups; i++)
+			hits.push_back(words[pick(random)]);
+	}
+	vector<string> misses = missingWords(lookups, words, random);
+
+	cout << words.size() << " words, " << hits.size() << " lookups of words in the index and " << misses.size()
+		<< " of words that aren't" << endl;
+	cout << endl;
+	cout << setw(16) << "structure" << setw(12) << "build ms" << setw(12) << "bulk ms" << setw(12) << "hit ns"
+		<< setw(12) << "miss ns" << setw(12) << "delete ms" << setw(12) << "peak MB" << endl;
+
+	string types[] = { "AVL", "HashMap", "BTree", "FlatHashMap", "ART", "PerfectHashMap" };
+	vector<string> reports;
+	for (int t = 0; t < 6; t++)
+		reports.push_back(runIsolated(types[t], words, order, hits, misses, indexFile));
+
+	out << "{" << endl;
+	out << "  \"source\": " << (indexFile != "" ? jsonString(indexFile) : "\"made up\"") << "," << endl;
+	out << "  \"words\": " << words.size() << "," << endl;
+	out << "  \"hit_lookups\": " << hits.size() << "," << endl;
+	out << "  \"miss_lookups\": " << misses.size() << "," << endl;
+	out << "  \"lookup_batch\": " << BATCH << "," << endl;
+	out << "  \"backends\": [" << endl;
+	for (int i = 0; i < reports.size(); i++)
+		out << "    " << reports[i] << (i + 1 < reports.size() ? "," : "") << endl;
+	out << "  ]" << endl;
+	out << "}" << endl;
+	cout << endl << "report written to " << reportFile << endl;
+	return 0;
+}
@@ -0,0 +1,118 @@
+/*File: BatchRunner.cpp
+ *Project: Search Engine
+ *this file contains the functionality of BatchRunner.h
+ */
+
+#include "BatchRunner.h"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+using namespace std;
+
+BatchRunner::BatchRunner(QueryServer* server, int numberOfClients, int limit)
+{
+	server_ = server;
+	numberOfClients_ = numberOfClients > 0 ? numberOfClients : 1;
+	limit_ = limit;
+	seconds_ = 0;
+	next_ = 0;
+}
+
+void BatchRunner::run(const vector<string>& queries)
+{
+	queries_ = queries;
+	results_.assign(queries.size(), QueryServer::Results());
+	latencies_.assign(queries.size(), 0);
+	next_ = 0;
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	vector<thread> clients;
+	for (int i = 0; i < numberOfClients_; i++)
+		clients.push_back(thread(&BatchRunner::client, this));
+	for (int i = 0; i < clients.size(); i++)
+		clients[i].join();
+	seconds_ = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	sort(latencies_.begin(), latencies_.end());
+}
+
+/**
+	client runs queries one after another until none are left, each client
+	has at most one query in flight so the latency includes time spent queued
+	behind the other clients
+**/
+void BatchRunner::client()
+{
+	while (true)
+	{
+		int query = next_++;
+		if (query >= queries_.size())
+			return;
+
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		results_[query] = server_->submit(queries_[query], limit_).get();
+		latencies_[query] = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+	}
+}
+
+void BatchRunner::writeResults(ostream& out)
+{
+	DocumentTable& documents = server_->getIndex()->getDocuments();
+	for (int i = 0; i < queries_.size(); i++)
+	{
+		out << "# " << queries_[i] << "\n";
+		for (int j = 0; j < results_[i].size(); j++)
+			out << documents.get(results_[i][j].docId).fileName << "\t" << results_[i][j].score << "\n";
+		out << "\n";
+	}
+	out.flush();
+}
+
+double BatchRunner::getSeconds()
+{
+	return seconds_;
+}
+
+double BatchRunner::getLatency(double percentile)
+{
+	if (latencies_.empty())
+		return 0;
+	int rank = (int)(percentile / 100 * latencies_.size() + 0.5) - 1;   // nearest rank
+	if (rank < 0)
+		rank = 0;
+	if (rank >= latencies_.size())
+		rank = latencies_.size() - 1;
+	return latencies_[rank];
+}
+
+/**
+	writeReport prints the percentiles and then the number of queries in
+	each power of two bucket of microseconds, with a bar scaled to the
+	largest bucket
+**/
+void BatchRunner::writeReport(ostream& out)
+{
+	out << "queries: " << queries_.size() << "  clients: " << numberOfClients_ << "  threads: " << server_->getNumberOfThreads() << "\n";
+	out << "seconds: " << seconds_ << "  queries per second: " << (seconds_ > 0 ? queries_.size() / seconds_ : 0) << "\n";
+	out << "latency (us)  p50: " << getLatency(50) << "  p90: " << getLatency(90) << "  p99: " << getLatency(99) << "  max: " << getLatency(100) << "\n";
+
+	vector<int> buckets;
+	for (int i = 0; i < latencies_.size(); i++)
+	{
+		int bucket = 0;
+		while ((1 << bucket) < latencies_[i] && bucket < 30)
+			bucket++;
+		if (bucket >= buckets.size())
+			buckets.resize(bucket + 1, 0);
+		buckets[bucket]++;
+	}
+	int largest = buckets.empty() ? 0 : *max_element(buckets.begin(), buckets.end());
+	for (int i = 0; i < buckets.size(); i++)
+	{
+		if (buckets[i] == 0)
+			continue;
+		out << "  <= " << (1 << i) << " us\t" << buckets[i] << "\t" << string(buckets[i] * 40 / largest, '#') << "\n";
+	}
+	out.flush();
+}
@@ -0,0 +1,45 @@
+/*File: BatchRunner.h
+ *Project: Search Engine
+ *this file implements a non interactive run of a list of queries against a query server
+ *a number of client threads each send one query at a time and wait for the answer, the
+ *time every query took is kept so the run can end with a latency and throughput report
+ */
+
+#ifndef BATCHRUNNER_H
+#define BATCHRUNNER_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <atomic>
+#include "QueryServer.h"
+
+using namespace std;
+
+class BatchRunner
+{
+public:
+	BatchRunner(QueryServer* server, int numberOfClients = 1, int limit = 10);
+
+	void run(const vector<string>& queries);
+	void writeResults(ostream& out);        //the top results of every query, in the order they were read
+	void writeReport(ostream& out);         //percentiles, a histogram of the latencies and queries per second
+
+	double getSeconds();
+	double getLatency(double percentile);   //microseconds, percentile between 0 and 100
+
+private:
+	void client();
+
+	QueryServer* server_;
+	int numberOfClients_;
+	int limit_;
+
+	vector<string> queries_;
+	vector<QueryServer::Results> results_;
+	vector<double> latencies_;              //microseconds, indexed like queries_ while running, sorted afterwards
+	atomic<int> next_;                      //next query a client thread takes
+	double seconds_;
+};
+
+#endif
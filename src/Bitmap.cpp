@@ -0,0 +1,338 @@
+/*File: Bitmap.cpp
+ *Project: Search Engine
+ *this file contains the functionality of Bitmap.h
+ */
+
+#include "Bitmap.h"
+#include "Word.h"
+#include <algorithm>
+
+using namespace std;
+
+int countBits(unsigned long long word)
+{
+	#if defined (__GNUC__) || defined (__clang__)
+		return __builtin_popcountll(word);
+	#else
+		int bits = 0;
+		for (; word != 0; word &= word - 1)
+			bits++;
+		return bits;
+	#endif
+}
+
+bool Bitmap::Container::contains(unsigned short low) const
+{
+	if (isBitmap())
+		return (bits[low >> 6] >> (low & 63)) & 1;
+	return binary_search(array.begin(), array.end(), low);
+}
+
+int Bitmap::Container::rank(unsigned short low) const
+{
+	if (!isBitmap())
+		return upper_bound(array.begin(), array.end(), low) - array.begin();
+	int word = low >> 6;
+	int total = ranks[word / RANK_WORDS];
+	for (int i = word - word % RANK_WORDS; i < word; i++)
+		total += countBits(bits[i]);
+	unsigned long long mask = (low & 63) == 63 ? ~0ULL : (2ULL << (low & 63)) - 1;
+	return total + countBits(bits[low >> 6] & mask);
+}
+
+void Bitmap::Container::toBits(vector<unsigned long long>& out) const
+{
+	if (isBitmap())
+	{
+		out = bits;
+		return;
+	}
+	out.assign(WORDS, 0);
+	for (int i = 0; i < array.size(); i++)
+		out[array[i] >> 6] |= 1ULL << (array[i] & 63);
+}
+
+void Bitmap::Container::fromBits(vector<unsigned long long>& in)
+{
+	cardinality = 0;
+	for (int i = 0; i < WORDS; i++)
+		cardinality += countBits(in[i]);
+
+	array.clear();
+	bits.clear();
+	ranks.clear();
+	if (cardinality > ARRAY_LIMIT)
+	{
+		bits.swap(in);
+		ranks.resize(WORDS / RANK_WORDS);
+		int total = 0;
+		for (int i = 0; i < WORDS; i++)
+		{
+			if (i % RANK_WORDS == 0)
+				ranks[i / RANK_WORDS] = total;
+			total += countBits(bits[i]);
+		}
+		return;
+	}
+	array.reserve(cardinality);
+	for (int i = 0; i < WORDS; i++)
+		for (unsigned long long word = in[i]; word != 0; word &= word - 1)
+		{
+			#if defined (__GNUC__) || defined (__clang__)
+				int bit = __builtin_ctzll(word);
+			#else
+				int bit = 0;
+				while (((word >> bit) & 1) == 0)
+					bit++;
+			#endif
+			array.push_back((unsigned short)(i * 64 + bit));
+		}
+}
+
+Bitmap::Bitmap()
+{
+	count = 0;
+}
+
+void Bitmap::build(const vector<int>& ascending)
+{
+	containers.clear();
+	before.clear();
+	count = 0;
+
+	int i = 0;
+	while (i < ascending.size())
+	{
+		Container container;
+		container.key = ascending[i] >> 16;
+		while (i < ascending.size() && (ascending[i] >> 16) == container.key)
+			container.array.push_back((unsigned short)(ascending[i++] & 0xFFFF));
+		container.cardinality = container.array.size();
+		if (container.cardinality > ARRAY_LIMIT)
+		{
+			vector<unsigned long long> bits;
+			container.toBits(bits);
+			container.fromBits(bits);
+		}
+		append(container);
+	}
+}
+
+void Bitmap::append(Container& container)
+{
+	if (container.cardinality == 0)
+		return;
+	before.push_back(count);
+	count += container.cardinality;
+	containers.push_back(Container());
+	containers.back().key = container.key;
+	containers.back().cardinality = container.cardinality;
+	containers.back().array.swap(container.array);
+	containers.back().bits.swap(container.bits);
+	containers.back().ranks.swap(container.ranks);
+}
+
+int Bitmap::findContainer(int key) const
+{
+	int low = 0;
+	int high = containers.size();
+	while (low < high)
+	{
+		int middle = (low + high) / 2;
+		if (containers[middle].key < key)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+	return low;
+}
+
+bool Bitmap::contains(int id) const
+{
+	int i = findContainer(id >> 16);
+	return i < containers.size() && containers[i].key == (id >> 16) && containers[i].contains(id & 0xFFFF);
+}
+
+int Bitmap::rank(int id) const
+{
+	int i = findContainer(id >> 16);
+	if (i == containers.size())
+		return count;
+	if (containers[i].key != (id >> 16))
+		return before[i];
+	return before[i] + containers[i].rank(id & 0xFFFF);
+}
+
+int Bitmap::cardinality() const
+{
+	return count;
+}
+
+int Bitmap::bytes() const
+{
+	int total = 0;
+	for (int i = 0; i < containers.size(); i++)
+		total += sizeof(Container) + containers[i].array.size() * sizeof(unsigned short) + containers[i].bits.size() * sizeof(unsigned long long)
+			+ containers[i].ranks.size() * sizeof(unsigned short);
+	return total;
+}
+
+void Bitmap::toVector(vector<int>& ids) const
+{
+	ids.clear();
+	ids.reserve(count);
+	vector<unsigned long long> bits;
+	for (int i = 0; i < containers.size(); i++)
+	{
+		int high = containers[i].key << 16;
+		if (!containers[i].isBitmap())
+		{
+			for (int j = 0; j < containers[i].array.size(); j++)
+				ids.push_back(high | containers[i].array[j]);
+			continue;
+		}
+		for (int w = 0; w < WORDS; w++)
+			for (int bit = 0; bit < 64; bit++)
+				if ((containers[i].bits[w] >> bit) & 1)
+					ids.push_back(high | (w * 64 + bit));
+	}
+}
+
+void Bitmap::filter(vector<int>& ids, bool keep) const
+{
+	int kept = 0;
+	for (int i = 0; i < ids.size(); i++)
+		if (contains(ids[i]) == keep)
+			ids[kept++] = ids[i];
+	ids.resize(kept);
+}
+
+/*
+ *the set operations walk both container lists by key. two arrays are merged, anything involving
+ *a full container is done 64 bits at a time and then shrunk back to an array if few ids are left
+ */
+
+Bitmap Bitmap::And(const Bitmap& a, const Bitmap& b)
+{
+	Bitmap result;
+	int i = 0;
+	int j = 0;
+	while (i < a.containers.size() && j < b.containers.size())
+	{
+		const Container& left = a.containers[i];
+		const Container& right = b.containers[j];
+		if (left.key < right.key)
+			i++;
+		else if (right.key < left.key)
+			j++;
+		else
+		{
+			Container both;
+			both.key = left.key;
+			if (!left.isBitmap() || !right.isBitmap())
+			{
+				const Container& small = left.isBitmap() ? right : left;    // an array checked against the other side
+				const Container& large = left.isBitmap() ? left : right;
+				for (int k = 0; k < small.array.size(); k++)
+					if (large.contains(small.array[k]))
+						both.array.push_back(small.array[k]);
+				both.cardinality = both.array.size();
+			}
+			else
+			{
+				vector<unsigned long long> bits(WORDS);
+				for (int w = 0; w < WORDS; w++)
+					bits[w] = left.bits[w] & right.bits[w];
+				both.fromBits(bits);
+			}
+			result.append(both);
+			i++;
+			j++;
+		}
+	}
+	return result;
+}
+
+Bitmap Bitmap::Or(const Bitmap& a, const Bitmap& b)
+{
+	Bitmap result;
+	int i = 0;
+	int j = 0;
+	while (i < a.containers.size() || j < b.containers.size())
+	{
+		Container either;
+		if (j == b.containers.size() || (i < a.containers.size() && a.containers[i].key < b.containers[j].key))
+			either = a.containers[i++];
+		else if (i == a.containers.size() || b.containers[j].key < a.containers[i].key)
+			either = b.containers[j++];
+		else
+		{
+			const Container& left = a.containers[i++];
+			const Container& right = b.containers[j++];
+			either.key = left.key;
+			if (!left.isBitmap() && !right.isBitmap() && left.cardinality + right.cardinality <= ARRAY_LIMIT)
+			{
+				set_union(left.array.begin(), left.array.end(), right.array.begin(), right.array.end(), back_inserter(either.array));
+				either.cardinality = either.array.size();
+			}
+			else
+			{
+				vector<unsigned long long> bits, rightBits;
+				left.toBits(bits);
+				right.toBits(rightBits);
+				for (int w = 0; w < WORDS; w++)
+					bits[w] |= rightBits[w];
+				either.fromBits(bits);
+			}
+		}
+		result.append(either);
+	}
+	return result;
+}
+
+Bitmap Bitmap::AndNot(const Bitmap& a, const Bitmap& b)
+{
+	Bitmap result;
+	int j = 0;
+	for (int i = 0; i < a.containers.size(); i++)
+	{
+		const Container& left = a.containers[i];
+		while (j < b.containers.size() && b.containers[j].key < left.key)
+			j++;
+		Container remaining;
+		if (j == b.containers.size() || b.containers[j].key != left.key)
+			remaining = left;
+		else if (!left.isBitmap())
+		{
+			remaining.key = left.key;
+			for (int k = 0; k < left.array.size(); k++)
+				if (!b.containers[j].contains(left.array[k]))
+					remaining.array.push_back(left.array[k]);
+			remaining.cardinality = remaining.array.size();
+		}
+		else
+		{
+			remaining.key = left.key;
+			vector<unsigned long long> bits, rightBits;
+			left.toBits(bits);
+			b.containers[j].toBits(rightBits);
+			for (int w = 0; w < WORDS; w++)
+				bits[w] &= ~rightBits[w];
+			remaining.fromBits(bits);
+		}
+		result.append(remaining);
+	}
+	return result;
+}
+
+void Bitmap::buildIndex(vector<Word*>& words, int numberOfPosts)
+{
+	for (int i = 0; i < words.size(); i++)
+	{
+		int postings = words[i]->getTotalNumberDocuments();
+		if (numberOfPosts > 0 && postings * DENSITY >= numberOfPosts)
+			words[i]->buildBitmap();
+		else
+			words[i]->dropBitmap();
+	}
+}
@@ -0,0 +1,66 @@
+/*File: Bitmap.h
+ *Project: Search Engine
+ *this file implements a compressed set of post ids for words found in a large share of the posts
+ *the ids are split on their high 16 bits into containers. a container holding up to 4096 ids keeps
+ *them as a sorted array of their low 16 bits, a fuller one as 65536 bits. sets of ids can be
+ *ANDed, ORed and ANDNOTed container by container, and a post id list filtered through one
+ */
+
+#ifndef BITMAP_H
+#define BITMAP_H
+
+#include <vector>
+
+using namespace std;
+
+class Word;
+
+class Bitmap
+{
+public:
+	static const int DENSITY = 16;      //a word gets a bitmap when it is in at least one post out of this many
+
+	Bitmap();
+
+	void build(const vector<int>& ascending);
+	bool contains(int id) const;
+	int rank(int id) const;             //how many ids in the set are <= id
+	int cardinality() const;
+	int bytes() const;
+	void toVector(vector<int>& ids) const;
+	void filter(vector<int>& ids, bool keep) const;     //keeps the ids in the set, or the ones not in it
+
+	static Bitmap And(const Bitmap& a, const Bitmap& b);
+	static Bitmap Or(const Bitmap& a, const Bitmap& b);
+	static Bitmap AndNot(const Bitmap& a, const Bitmap& b);
+
+	//gives every word dense enough a bitmap of its postings and takes it away from the others
+	static void buildIndex(vector<Word*>& words, int numberOfPosts);
+
+private:
+	static const int ARRAY_LIMIT = 4096;
+	static const int WORDS = 1024;      //64 bit words in a full container
+	static const int RANK_WORDS = 8;    //words counted past a block's stored rank at most
+
+	struct Container {
+		int key;                        //the high 16 bits shared by the ids
+		int cardinality;
+		vector<unsigned short> array;   //used while cardinality <= ARRAY_LIMIT
+		vector<unsigned long long> bits;
+		vector<unsigned short> ranks;   //set bits in the words ahead of each block of RANK_WORDS, kept with bits
+		bool isBitmap() const { return !bits.empty(); }
+		bool contains(unsigned short low) const;
+		int rank(unsigned short low) const;
+		void toBits(vector<unsigned long long>& out) const;
+		void fromBits(vector<unsigned long long>& in);  //counts the bits and goes back to an array if few are set
+	};
+
+	int findContainer(int key) const;
+	void append(Container& container);  //keys ascending, empty containers are dropped
+
+	vector<Container> containers;
+	vector<int> before;                 //ids in the containers ahead of each one, for rank
+	int count;
+};
+
+#endif
@@ -0,0 +1,119 @@
+/*File: Compressor.cpp
+ *Project: Search Engine
+ *this file contains the functionality of Compressor.h
+ */
+
+#include "Compressor.h"
+#include <vector>
+#include <string.h>
+
+using namespace std;
+
+/*
+ *a sequence starts with a byte holding the literal count in its high four bits and the match
+ *length minus MIN_MATCH in its low four. a value of 15 is continued in extra bytes that are added
+ *on until one is below 255. then come the literals, the two byte distance (low byte first) and
+ *the extra match length bytes. the last sequence stops after its literals
+ */
+
+void writeLength(string& out, int length)
+{
+	while (length >= 255)
+	{
+		out += (char)255;
+		length -= 255;
+	}
+	out += (char)length;
+}
+
+void writeSequence(string& out, const string& text, int literalStart, int literalCount, int distance, int matchLength)
+{
+	int matchCode = matchLength > 0 ? matchLength - 4 : 0;
+	out += (char)(((literalCount < 15 ? literalCount : 15) << 4) | (matchCode < 15 ? matchCode : 15));
+	if (literalCount >= 15)
+		writeLength(out, literalCount - 15);
+	out.append(text, literalStart, literalCount);
+	if (matchLength == 0)
+		return;
+	out += (char)(distance & 0xFF);
+	out += (char)(distance >> 8);
+	if (matchCode >= 15)
+		writeLength(out, matchCode - 15);
+}
+
+unsigned int hashFour(const char* p, int bits)
+{
+	unsigned int four;
+	memcpy(&four, p, 4);
+	return (four * 2654435761U) >> (32 - bits);
+}
+
+string Compressor::compress(const string& text)
+{
+	string out;
+	vector<int> lastSeen(1 << HASH_BITS, -1);     //where each hash of four bytes was last found
+	int size = text.size();
+	int literalStart = 0;
+	int i = 0;
+	while (i + MIN_MATCH <= size)
+	{
+		unsigned int hash = hashFour(text.data() + i, HASH_BITS);
+		int candidate = lastSeen[hash];
+		lastSeen[hash] = i;
+		if (candidate < 0 || i - candidate > MAX_DISTANCE || memcmp(text.data() + candidate, text.data() + i, MIN_MATCH) != 0)
+		{
+			i++;
+			continue;
+		}
+
+		int length = MIN_MATCH;
+		while (i + length < size && text[candidate + length] == text[i + length])
+			length++;
+		writeSequence(out, text, literalStart, i - literalStart, i - candidate, length);
+		i += length;
+		literalStart = i;
+	}
+	writeSequence(out, text, literalStart, size - literalStart, 0, 0);
+	return out;
+}
+
+int readLength(const string& in, int& i, int length)
+{
+	if (length < 15)
+		return length;
+	while (i < in.size())
+	{
+		unsigned char extra = in[i++];
+		length += extra;
+		if (extra != 255)
+			break;
+	}
+	return length;
+}
+
+string Compressor::decompress(const string& compressed)
+{
+	string out;
+	int i = 0;
+	while (i < compressed.size())
+	{
+		unsigned char token = compressed[i++];
+		int literalCount = readLength(compressed, i, token >> 4);
+		if (i + literalCount > compressed.size())
+			break;              // damaged input, keep what was decoded
+		out.append(compressed, i, literalCount);
+		i += literalCount;
+		if (i + 2 > compressed.size())
+			break;              // the last sequence has no match
+
+		int distance = (unsigned char)compressed[i] | ((unsigned char)compressed[i + 1] << 8);
+		i += 2;
+		int length = readLength(compressed, i, token & 0x0F) + MIN_MATCH;
+		if (distance == 0 || distance > out.size())
+			break;
+		int from = out.size() - distance;
+		for (int k = 0; k < length; k++)    // byte by byte, a match may overlap the bytes it is copying
+			out += out[from + k];
+	}
+	return out;
+}
@@ -0,0 +1,27 @@
+/*File: Compressor.h
+ *Project: Search Engine
+ *this file implements a small LZ77 style compressor for the post bodies kept with the index
+ *the output is a run of sequences, each a count of literal bytes copied as they are followed by a
+ *copy of earlier output given by its distance back and length, which suits repetitive Usenet text
+ */
+
+#ifndef COMPRESSOR_H
+#define COMPRESSOR_H
+
+#include <string>
+
+using namespace std;
+
+class Compressor
+{
+public:
+	static string compress(const string& text);
+	static string decompress(const string& compressed);
+
+private:
+	static const int MIN_MATCH = 4;
+	static const int MAX_DISTANCE = 65535;
+	static const int HASH_BITS = 12;
+};
+
+#endif
@@ -0,0 +1,391 @@
+/*File: DocumentTable.cpp
+ *Project: Search Engine
+ *this file contains the functionality of DocumentTable.h
+ */
+
+#include "DocumentTable.h"
+#include "Compressor.h"
+#include "Word.h"
+#include <fstream>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <algorithm>
+
+using namespace std;
+
+DocumentTable::DocumentTable()
+{
+	totalLength = 0;
+}
+int DocumentTable::add(string fileName, int length, int year, int month, string strmonth, int day)
+{
+	unordered_map<string, int>::iterator it = ids.find(fileName);
+	if(it != ids.end())
+	{
+		return it->second;
+	}
+	Document document;
+	document.fileName = fileName;
+	document.length = length;
+	document.year = year;
+	document.month = month;
+	document.day = day;
+	document.strmonth = strmonth;
+	documents.push_back(document);
+	lengths.push_back(length);
+	dates.push_back(packDate(year, month, day));
+	totalLength += length;
+	int docId = documents.size() - 1;
+	ids[fileName] = docId;
+	return docId;
+}
+int DocumentTable::find(string fileName)
+{
+	unordered_map<string, int>::iterator it = ids.find(fileName);
+	if(it == ids.end())
+	{
+		return -1;
+	}
+	return it->second;
+}
+DocumentTable::Document& DocumentTable::get(int docId)
+{
+	return documents[docId];
+}
+const vector<int>& DocumentTable::getLengths()
+{
+	return lengths;
+}
+const vector<int>& DocumentTable::getDates()
+{
+	return dates;
+}
+int DocumentTable::packDate(int year, int month, int day)
+{
+	return year * 10000 + month * 100 + day;
+}
+int DocumentTable::size()
+{
+	return documents.size();
+}
+double DocumentTable::averageLength()
+{
+	if(documents.empty())
+	{
+		return 0;
+	}
+	return (double)totalLength / (double)documents.size();
+}
+void DocumentTable::clear()
+{
+	documents.clear();
+	lengths.clear();
+	dates.clear();
+	ids.clear();
+	totalLength = 0;
+	fieldText.clear();
+	fieldsAt.clear();
+	bodies.clear();
+	tokenOffsets.clear();
+}
+void DocumentTable::setFields(int docId, const vector<string>& values)
+{
+	if(fieldsAt.size() <= docId)
+	{
+		fieldsAt.resize(docId + 1, -1);
+	}
+	fieldsAt[docId] = fieldText.size();
+	for(int i = 0; i < NUMBER_OF_FIELDS; i++)
+	{
+		if(i < values.size())
+		{
+			fieldText += values[i];
+		}
+		fieldText += '\0';
+	}
+}
+string DocumentTable::getField(int docId, int field)
+{
+	if(docId >= fieldsAt.size() || fieldsAt[docId] == -1)
+	{
+		return "";
+	}
+	const char* text = fieldText.c_str() + fieldsAt[docId];
+	for(int i = 0; i < field; i++)
+	{
+		text += strlen(text) + 1;
+	}
+	return text;
+}
+/*
+ *the fields section is a line "fields <number of posts>" and then for each post its
+ *file name followed by one line per field. index files written before it existed end
+ *after the words, so readers treat a missing section as posts without stored headers
+ */
+void DocumentTable::writeFields(ostream& out)
+{
+	int stored = 0;
+	for(int i = 0; i < fieldsAt.size(); i++)
+	{
+		if(fieldsAt[i] != -1)
+		{
+			stored++;
+		}
+	}
+	out << "fields " << stored << "\n";
+	for(int i = 0; i < fieldsAt.size(); i++)
+	{
+		if(fieldsAt[i] == -1)
+		{
+			continue;
+		}
+		out << documents[i].fileName << "\n";
+		for(int j = 0; j < NUMBER_OF_FIELDS; j++)
+		{
+			out << getField(i, j) << "\n";
+		}
+	}
+}
+void DocumentTable::readFields(istream& in, string sectionLine)
+{
+	if(sectionLine.find("fields ") != 0)
+	{
+		return;
+	}
+	int stored = atoi(sectionLine.substr(7).c_str());
+	vector<string> values(NUMBER_OF_FIELDS);
+	for(int i = 0; i < stored; i++)
+	{
+		string fileName;
+		getline(in, fileName);
+		for(int j = 0; j < NUMBER_OF_FIELDS; j++)
+		{
+			getline(in, values[j]);
+		}
+		int docId = find(fileName);
+		if(docId != -1)		//a post with no indexed words has no entry to attach the fields to
+		{
+			setFields(docId, values);
+		}
+	}
+}
+void DocumentTable::setBody(int docId, const string& body, const vector<int>& offsets)
+{
+	if(bodies.size() <= docId)
+	{
+		bodies.resize(docId + 1);
+		tokenOffsets.resize(docId + 1);
+	}
+	bodies[docId] = Compressor::compress(body);
+	tokenOffsets[docId] = Word::encodeGaps(offsets);
+}
+bool DocumentTable::hasBody(int docId)
+{
+	return docId < bodies.size() && !bodies[docId].empty();
+}
+string DocumentTable::getBody(int docId)
+{
+	if(!hasBody(docId))
+	{
+		return "";
+	}
+	return Compressor::decompress(bodies[docId]);
+}
+vector<int> DocumentTable::getTokenOffsets(int docId)
+{
+	if(docId >= tokenOffsets.size())
+	{
+		return vector<int>();
+	}
+	return Word::decodeGaps(tokenOffsets[docId]);
+}
+/*
+ *the bodies file holds, for every post with a body, its file name, compressed body and coded word
+ *offsets, each as a varint length followed by that many bytes
+ */
+void writeBlock(ostream& out, const string& block)
+{
+	vector<int> length(1, block.size());
+	out << Word::encodeGaps(length) << block;
+}
+bool readBlock(istream& in, string& block)
+{
+	unsigned int length = 0;
+	int shift = 0;
+	int byte;
+	while((byte = in.get()) != EOF)
+	{
+		length |= (unsigned int)(byte & 0x7F) << shift;
+		if(!(byte & 0x80))
+		{
+			break;
+		}
+		shift += 7;
+	}
+	if(byte == EOF)
+	{
+		return false;
+	}
+	block.resize(length);
+	in.read(&block[0], length);
+	return in.gcount() == length;
+}
+void DocumentTable::writeBodies(string fileName)
+{
+	bool any = false;
+	for(int i = 0; i < bodies.size() && !any; i++)
+	{
+		any = !bodies[i].empty();
+	}
+	if(!any)
+	{
+		return;
+	}
+	ofstream out(fileName.c_str(), ios::binary);
+	if(!out.is_open())
+	{
+		cerr << "There was an error creating the bodies file" << endl;
+		return;
+	}
+	for(int i = 0; i < bodies.size(); i++)
+	{
+		if(bodies[i].empty())
+		{
+			continue;
+		}
+		writeBlock(out, documents[i].fileName);
+		writeBlock(out, bodies[i]);
+		writeBlock(out, tokenOffsets[i]);
+	}
+}
+void DocumentTable::readBodies(string fileName)
+{
+	ifstream in(fileName.c_str(), ios::binary);
+	string name, body, offsets;
+	while(in.is_open() && readBlock(in, name) && readBlock(in, body) && readBlock(in, offsets))
+	{
+		int docId = find(name);
+		if(docId == -1)
+		{
+			continue;
+		}
+		if(bodies.size() <= docId)
+		{
+			bodies.resize(docId + 1);
+			tokenOffsets.resize(docId + 1);
+		}
+		bodies[docId] = body;
+		tokenOffsets[docId] = offsets;
+	}
+}
+/*
+ *the snippet is the window of length words holding the most hits, found by sliding the window
+ *over the sorted hits, and is cut from the body at the stored offsets instead of rereading the post
+ */
+string DocumentTable::snippet(int docId, const vector<int>& tokenHits, int length)
+{
+	string body = getBody(docId);
+	vector<int> offsets = getTokenOffsets(docId);
+	if(body.empty() || offsets.empty())
+	{
+		return "";
+	}
+
+	vector<int> hits = tokenHits;
+	sort(hits.begin(), hits.end());
+	int first = 0;
+	int best = 0;
+	for(int i = 0, j = 0; i < hits.size(); i++)
+	{
+		while(hits[i] - hits[j] >= length)
+		{
+			j++;
+		}
+		if(i - j + 1 > best)
+		{
+			best = i - j + 1;
+			first = hits[j];
+		}
+	}
+	first -= length / 4;		//a little context before the first hit
+	if(first + length > offsets.size())
+	{
+		first = offsets.size() - length;
+	}
+	if(first < 0)
+	{
+		first = 0;
+	}
+	int last = first + length < offsets.size() ? first + length : offsets.size();
+
+	string out = first > 0 ? "..." : "";
+	int hit = lower_bound(hits.begin(), hits.end(), first) - hits.begin();
+	for(int token = first; token < last; token++)
+	{
+		int start = offsets[token];
+		int end = start;
+		while(end < body.size() && !isspace((unsigned char)body[end]))
+		{
+			end++;
+		}
+		bool highlighted = hit < hits.size() && hits[hit] == token;
+		while(hit < hits.size() && hits[hit] <= token)
+		{
+			hit++;
+		}
+		if(token > first)
+		{
+			out += " ";
+		}
+		out += highlighted ? "[" + body.substr(start, end - start) + "]" : body.substr(start, end - start);
+	}
+	if(last < offsets.size())
+	{
+		out += "...";
+	}
+	return out;
+}
+int DocumentTable::headerField(const string& line)
+{
+	static const char* headers[NUMBER_OF_FIELDS] = { "from:", "subject:", "newsgroups:", "message-id:" };
+	for(int i = 0; i < NUMBER_OF_FIELDS; i++)
+	{
+		int length = strlen(headers[i]);
+		if(line.size() < length)
+		{
+			continue;
+		}
+		int j = 0;
+		while(j < length && tolower(line[j]) == headers[i][j])
+		{
+			j++;
+		}
+		if(j == length)
+		{
+			return i;
+		}
+	}
+	return -1;
+}
+string DocumentTable::headerValue(const string& line)
+{
+	int start = line.find(':') + 1;
+	while(start < line.size() && line[start] == ' ')
+	{
+		start++;
+	}
+	string value = line.substr(start);
+	for(int i = 0; i < value.size(); i++)
+	{
+		if(value[i] == '\t' || value[i] == '\r' || value[i] == '\0')
+		{
+			value[i] = ' ';		//tabs separate the columns the query daemon sends
+		}
+	}
+	while(value.size() > 0 && value[value.size() - 1] == ' ')
+	{
+		value.erase(value.size() - 1);
+	}
+	return value;
+}
@@ -0,0 +1,74 @@
+/*File: DocumentTable.h
+ *Project: Search Engine
+ *this file implements the table of posts in an index, each post gets a small integer id
+ *so per post values can be kept in arrays instead of being repeated in every posting
+ *the headers shown with a result (From, Subject, Newsgroups, Message-ID) are stored here too,
+ *read once by the parser so listing results never opens the posts. a compressed copy of each
+ *body and where each of its words starts are kept as well, for the snippets shown with results
+ */
+
+#ifndef DOCUMENTTABLE_H
+#define DOCUMENTTABLE_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+using namespace std;
+
+class DocumentTable
+{
+public:
+	struct Document {
+		string fileName;
+		int length;             //total words in the post
+		int year, month, day;
+		string strmonth;
+	};
+
+	enum Field { FROM, SUBJECT, NEWSGROUPS, MESSAGE_ID, NUMBER_OF_FIELDS };
+
+	DocumentTable();
+
+	int add(string fileName, int length, int year, int month, string strmonth, int day);  //returns the post's id, adding it if it is new
+	int find(string fileName);          //-1 when the post is not in the table
+	Document& get(int docId);
+	const vector<int>& getLengths();    //every post's length by post id, the column the scorers read
+	const vector<int>& getDates();      //every post's date by post id as packDate numbers, the column the date filters read
+	int size();
+	double averageLength();
+	void clear();
+
+	void setFields(int docId, const vector<string>& values);   //NUMBER_OF_FIELDS values in Field order
+	string getField(int docId, int field);                      //empty when the post has no stored headers
+	void writeFields(ostream& out);         //the fields section at the end of an index file
+	void readFields(istream& in, string sectionLine);           //the section started by sectionLine, for posts already in the table
+
+	void setBody(int docId, const string& body, const vector<int>& tokenOffsets);
+	bool hasBody(int docId);
+	string getBody(int docId);
+	vector<int> getTokenOffsets(int docId);     //byte offset in the body of each word, stop words included
+	void writeBodies(string fileName);          //the bodies live in a binary file beside the index file
+	void readBodies(string fileName);           //does nothing if the index was written without one
+
+	//the words around tokenHits (token numbers within the body) with the hits in [brackets]
+	string snippet(int docId, const vector<int>& tokenHits, int length);
+
+	static int packDate(int year, int month, int day);  //yyyymmdd, so later dates are larger numbers
+	static int headerField(const string& line);     //the Field a header line holds, -1 for any other line
+	static string headerValue(const string& line);  //the text after the header's colon
+
+private:
+	vector<Document> documents;
+	vector<int> lengths;                //columns copied out of documents, a loop over many posts
+	vector<int> dates;                  //reads these instead of striding over whole Documents
+	unordered_map<string, int> ids;
+	long long totalLength;
+	string fieldText;                   //every post's fields back to back, each ended by a '\0'
+	vector<int> fieldsAt;               //where a post's fields start in fieldText, -1 if it has none
+	vector<string> bodies;              //compressed, by post id
+	vector<string> tokenOffsets;        //varint coded gaps, by post id
+};
+
+#endif
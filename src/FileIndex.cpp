@@ -0,0 +1,26 @@
+#include "FileIndex.h"
+#include "AVL.h"
+#include "HashMap.h"
+#include "BTree.h"
+#include "FlatHashMap.h"
+#include "ART.h"
+#include "PerfectHashMap.h"
+
+using namespace std;
+
+FileIndex* FileIndex::create(string type)
+{
+	if(type == "AVL")
+		return new AVL;
+	else if(type == "HashMap")
+		return new HashMap;
+	else if(type == "BTree")
+		return new BTree;
+	else if(type == "FlatHashMap")
+		return new FlatHashMap;
+	else if(type == "ART")
+		return new ART;
+	else if(type == "PerfectHashMap")
+		return new PerfectHashMap;
+	return NULL;
+}
@@ -1,7 +1,13 @@
 #ifndef FILEINDEX_H
 #define FILEINDEX_H
 #include <iostream> 
+#include <new>
+#include <string_view>
 #include "Word.h"
+#include "Arena.h"
+#include "TermDictionary.h"
+#include "Suggester.h"
+#include "DocumentTable.h"
 
 
 using namespace std;
@@ -9,24 +15,127 @@ using namespace std;
 class FileIndex
 {
 public:
-	virtual ~FileIndex() {}
+	FileIndex() { corpusSize = 0; totalNumberOfWords = 0; positionsStored = false; dictionary = NULL; suggester = NULL; impactScorer = ""; impactBits = 0; }
+	virtual ~FileIndex() { delete suggester; delete dictionary; }   //structures end their words first, see releaseWords
+	static FileIndex* create(string type);             //"AVL", "HashMap", "BTree", "FlatHashMap", "ART" or "PerfectHashMap", NULL for anything else
 
 	//virtual void insert(string key, Word* newWord) = 0;
-	virtual void insert(Word* newWord) = 0;
+	virtual void insert(Word* newWord) = 0;     //the structure owns the word, a word already in it takes newWord's files and newWord is freed
 	virtual void printValues(int i) = 0;
 	virtual void del(Word* deleteValue) = 0;
-	virtual Word* find(string lookup) = 0;
+	virtual Word* find(string_view lookup) = 0;         //views the key, a lookup copies nothing
 	virtual int nonodes() = 0;          //returns the number of elements in the structure dont ask me why its named this
 	virtual void clear() = 0;
 	virtual void writeToFile(string fileName)=0;
+	virtual void getWords(vector<Word*>& words) = 0;   //every word in the structure, in no particular order
+	//builds the structure from words in strictly increasing order in time linear in their number, as read from an index
+	//file marked sorted. a structure that already holds words, or has no faster way, inserts them one at a time
+	virtual void bulkLoad(vector<Word*>& words) { for(int i = 0; i < words.size(); i++) insert(words[i]); }
+	//appends up to limit words starting with prefix in sorted order, structures that
+	//are already ordered can override this to skip building the sorted dictionary
+	virtual void findPrefix(string_view prefix, vector<Word*>& words, int limit)
+	{
+		TermDictionary* terms = getDictionary();
+		int first, last;
+		terms->prefixRange(prefix, first, last);
+		for(int i = first; i < last && words.size() < limit; i++)
+			words.push_back(terms->at(i));
+	}
+	//the section of the index file read after the fields, only a PerfectHashMap writes one, see PerfectHash::write
+	virtual void readPerfectHash(istream&, string) {}
+	//builds what the query path would otherwise build on first use. until the structure is changed
+	//again it is then only read by queries, so many threads can search it without locking. with
+	//rankByImpact every word also keeps its postings best first, for getRankOrder
+	void finalize(bool rankByImpact = false)
+	{
+		TermDictionary* terms = getDictionary();
+		if(rankByImpact)
+			for(int i = 0; i < terms->size(); i++)
+				terms->at(i)->freeze(true);
+		getSuggester();
+	}
+	bool isFinalized() { return dictionary != NULL; }
+	DocumentTable& getDocuments() { return documents; }  //posts referenced by the postings, by id
+	Word* newWord(string word) { return new (arena.allocate(sizeof(Word))) Word(word, &arena); }   //a word to insert, it and its files are bump allocated in this index's arena
+	Arena& getArena() { return arena; }
+	TermDictionary* getDictionary()                      //sorted view of the words, rebuilt after the structure changes, along with the bitmaps of common words
+	{
+		if(dictionary == NULL)
+		{
+			vector<Word*> words;
+			getWords(words);
+			for(int i = 0; i < words.size(); i++)
+				words[i]->freeze(false);                //sorted once here, queries only read the postings
+			dictionary = new TermDictionary(words);
+			Bitmap::buildIndex(words, documents.size());
+		}
+		return dictionary;
+	}
+	Suggester* getSuggester()                            //spelling corrections drawn from the dictionary, rebuilt along with it
+	{
+		if(suggester == NULL)
+			suggester = new Suggester(getDictionary());
+		return suggester;
+	}
 	void incrementCorpusSize() { corpusSize++; }
 	int getCorpusSize(){ return corpusSize; }
 	void setCorpusSize(int newCorpusSize) { corpusSize = newCorpusSize; }
 	int getTotalNumberOfWords() { return totalNumberOfWords; }
 	void setTotalNumberOfWords(int newTotalNumberOfWords) { totalNumberOfWords = newTotalNumberOfWords; }
+	bool storesPositions() { return positionsStored; }      //true when every posting carries its word offsets (phrase queries)
+	void setStoresPositions(bool stored) { positionsStored = stored; }
+	string getImpactScorer() { return impactScorer; }       //name of the scorer the words' quantized impacts came from, empty when there are none
+	int getImpactBits() { return impactBits; }
+	void setImpactScorer(string scorer, int bits) { impactScorer = scorer; impactBits = bits; }
+	bool storesImpacts() { return impactScorer != ""; }      //true when the postings are written with their impacts in place of exact scores
+	void writeHeader(ostream& outFile)                      //first two lines of an index file, shared by every structure
+	{
+		outFile << corpusSize;
+		if(positionsStored)
+			outFile << " positions";
+		outFile << " sorted";                               //every structure writes its words in order, so loading can use bulkLoad
+		if(storesImpacts())
+			outFile << " impacts " << impactScorer << " " << impactBits;
+		outFile << endl;
+		outFile << nonodes() << endl;
+	}
+
+protected:
+	void invalidateDictionary() { delete suggester; suggester = NULL; delete dictionary; dictionary = NULL; impactScorer = ""; impactBits = 0; }
+	//the structure owns the words inserted into it. this ends all of them, those from newWord only run their
+	//destructors, and then gives the arena's chunks back. the structure may not follow its pointers afterwards
+	void releaseWords()
+	{
+		invalidateDictionary();
+		vector<Word*> words;
+		getWords(words);
+		for(int i = 0; i < words.size(); i++)
+			destroyWord(words[i]);
+		arena.release();
+	}
+	//an inserted word whose files went to the word already in the structure, see Word::takeFiles
+	void mergeWord(Word* existing, Word* newWord)
+	{
+		existing->takeFiles(newWord);
+		destroyWord(newWord);
+	}
+	void destroyWord(Word* word)
+	{
+		if(word->getArena() != NULL)
+			word->~Word();      //its memory goes back with the arena's chunks
+		else
+			delete word;
+	}
 	
 private:
+	TermDictionary* dictionary;
+	Suggester* suggester;
+	DocumentTable documents;
+	Arena arena;
 	int corpusSize;
 	int totalNumberOfWords;
+	bool positionsStored;
+	string impactScorer;
+	int impactBits;
 };
 #endif
@@ -0,0 +1,255 @@
+/*File: FlatHashMap.cpp
+ *Project: Search Engine
+ *this file contains the functionality of FlatHashMap.h
+ */
+
+#include "FlatHashMap.h"
+#include <functional>
+
+#if defined (__SSE2__) || defined (_M_X64)
+	#include <emmintrin.h>
+	#define FLATHASHMAP_SSE2
+#endif
+
+using namespace std;
+
+const signed char FlatHashMap::EMPTY;
+const signed char FlatHashMap::DELETED;
+
+int lowestBit(unsigned int bits)
+{
+	#if defined (__GNUC__) || defined (__clang__)
+		return __builtin_ctz(bits);
+	#else
+		int bit = 0;
+		while (((bits >> bit) & 1) == 0)
+			bit++;
+		return bit;
+	#endif
+}
+
+FlatHashMap::FlatHashMap()
+{
+	size = 0;
+	rehash(1);
+}
+
+FlatHashMap::~FlatHashMap()
+{
+	releaseWords();
+}
+
+unsigned int FlatHashMap::match(const signed char* group, signed char control)
+{
+	#if defined (FLATHASHMAP_SSE2)
+		__m128i bytes = _mm_loadu_si128((const __m128i*)group);
+		return _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(control)));
+	#else
+		unsigned int bits = 0;
+		for (int i = 0; i < GROUP; i++)
+			if (group[i] == control)
+				bits |= 1U << i;
+		return bits;
+	#endif
+}
+
+size_t FlatHashMap::hashOf(string_view key)
+{
+	return hash<string_view>()(key);
+}
+
+/*
+ *the low seven bits of the hash are the control byte and the rest pick the first group. the groups
+ *after it are tried 1, 2, 3... apart, which visits every group when there is a power of two of them.
+ *a probe can stop at the first group with an empty slot, since an insert would have used that slot.
+ *the slots keep a word's first sixteen letters, so only words that long are read to compare them
+ */
+int FlatHashMap::findSlot(string_view key, size_t hash)
+{
+	signed char fragment = hash & 0x7F;
+	int group = (hash >> 7) & groupMask;
+	unsigned long long prefix = Word::packLetters(key, 0);
+	unsigned long long suffix = Word::packLetters(key, 8);
+	bool complete = key.size() < 16;	//the letters kept in the slot are the whole word
+	for (int step = 1; ; step++)
+	{
+		const signed char* control = &controls[group * GROUP];
+		for (unsigned int bits = match(control, fragment); bits != 0; bits &= bits - 1)
+		{
+			int slot = group * GROUP + lowestBit(bits);
+			if (slots[slot].prefix == prefix && slots[slot].suffix == suffix && (complete || slots[slot].word->getKey() == key))
+				return slot;
+		}
+		if (match(control, EMPTY) != 0 || step > groupMask)
+			return -1;
+		group = (group + step) & groupMask;
+	}
+}
+
+void FlatHashMap::place(Word* word, size_t hash)
+{
+	int group = (hash >> 7) & groupMask;
+	for (int step = 1; ; step++)
+	{
+		const signed char* control = &controls[group * GROUP];
+		unsigned int free = match(control, EMPTY) | match(control, DELETED);
+		if (free != 0)
+		{
+			int slot = group * GROUP + lowestBit(free);
+			if (controls[slot] == DELETED)
+				tombstones--;
+			controls[slot] = hash & 0x7F;
+			slots[slot].word = word;
+			slots[slot].prefix = Word::packLetters(word->getKey(), 0);
+			slots[slot].suffix = Word::packLetters(word->getKey(), 8);
+			return;
+		}
+		group = (group + step) & groupMask;
+	}
+}
+
+//moves every word into fresh arrays of newGroups groups, which also clears out the tombstones
+void FlatHashMap::rehash(int newGroups)
+{
+	vector<signed char> oldControls(newGroups * GROUP, EMPTY);
+	vector<Slot> oldSlots(newGroups * GROUP);
+	oldControls.swap(controls);
+	oldSlots.swap(slots);
+	groupMask = newGroups - 1;
+	tombstones = 0;
+	for (int i = 0; i < oldSlots.size(); i++)
+		if (oldControls[i] >= 0)
+			place(oldSlots[i].word, hashOf(oldSlots[i].word->getKey()));
+}
+
+void FlatHashMap::insert(Word* newWord)
+{
+	invalidateDictionary();
+	const string& key = newWord->getKey();
+	size_t hash = hashOf(key);
+	int slot = findSlot(key, hash);
+	if (slot >= 0)
+	{
+		mergeWord(slots[slot].word, newWord);
+		return;
+	}
+
+	if ((size + tombstones + 1) * 8 > slots.size() * 7)	//at most seven eighths full, counting the tombstones
+	{
+		int groups = groupMask + 1;
+		while ((size + 1) * 2 > groups * GROUP)	//at most half full after the rehash, or just cleared of tombstones
+			groups *= 2;
+		rehash(groups);
+	}
+	place(newWord, hash);
+	size++;
+}
+
+//a slot whose group still has an empty slot can be emptied too, no probe went on past that group.
+//the word is ended once its slot is let go of, the way the structure ends its words
+void FlatHashMap::del(Word* deleteValue)
+{
+	invalidateDictionary();
+	int slot = findSlot(deleteValue->getKey(), hashOf(deleteValue->getKey()));
+	if (slot < 0)
+	{
+		cout << "element not found" << endl;
+		return;
+	}
+	if (match(&controls[slot - slot % GROUP], EMPTY) != 0)
+		controls[slot] = EMPTY;
+	else
+	{
+		controls[slot] = DELETED;
+		tombstones++;
+	}
+	size--;
+	Word* word = slots[slot].word;
+	slots[slot].word = NULL;
+	destroyWord(word);
+}
+
+Word* FlatHashMap::find(string_view lookup)
+{
+	int slot = findSlot(lookup, hashOf(lookup));
+	return slot < 0 ? NULL : slots[slot].word;
+}
+
+int FlatHashMap::nonodes()
+{
+	return size;
+}
+
+int FlatHashMap::capacity()
+{
+	return slots.size();
+}
+
+int FlatHashMap::bytes()
+{
+	return controls.size() * sizeof(signed char) + slots.size() * sizeof(Slot);
+}
+
+void FlatHashMap::clear()
+{
+	getDocuments().clear();
+	releaseWords();
+	vector<signed char>(GROUP, EMPTY).swap(controls);
+	vector<Slot>(GROUP).swap(slots);
+	groupMask = 0;
+	size = 0;
+	tombstones = 0;
+}
+
+void FlatHashMap::bulkLoad(vector<Word*>& words)
+{
+	if (size != 0)
+	{
+		FileIndex::bulkLoad(words);
+		return;
+	}
+	invalidateDictionary();
+	int groups = 1;
+	while (words.size() * 2 > groups * GROUP)	//half full, as an insert leaves it after growing
+		groups *= 2;
+	rehash(groups);
+	for (int i = 0; i < words.size(); i++)
+		place(words[i], hashOf(words[i]->getKey()));
+	size = words.size();
+}
+
+void FlatHashMap::getWords(vector<Word*>& words)
+{
+	for (int i = 0; i < slots.size(); i++)
+		if (controls[i] >= 0)
+			words.push_back(slots[i].word);
+}
+
+void FlatHashMap::printValues(int)
+{
+	for (int j = 0; j < slots.size(); j++)
+		if (controls[j] >= 0)
+			cout << slots[j].word->getKey() << endl;
+}
+
+void FlatHashMap::writeToFile(string fileName)
+{
+	ofstream outFile;
+	outFile.open(fileName.c_str());
+	if (!outFile.is_open())
+	{
+		cerr << "file not found" << endl;
+	}
+	else
+	{
+		writeHeader(outFile);
+		vector<Word*> words;
+		getWords(words);
+		sort(words.begin(), words.end(), Word::keyLess);	//the header says the words are sorted
+		for (int i = 0; i < words.size(); i++)
+			words[i]->write(outFile, storesPositions(), storesImpacts(), &getDocuments());
+		getDocuments().writeFields(outFile);
+		outFile.close();
+		getDocuments().writeBodies(fileName + ".bodies");
+	}
+}
@@ -0,0 +1,64 @@
+/*File: FlatHashMap.h
+ *Project: Search Engine
+ *this file implements an open addressing hash table of the index's words, laid out like a Swiss table.
+ *the words sit in one array of slots with a control byte each, holding seven bits of the word's hash,
+ *and a lookup checks sixteen control bytes at once before it reads any of the slots
+ */
+
+#ifndef FLATHASHMAP_H
+#define FLATHASHMAP_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fstream>
+#include "Word.h"
+#include "FileIndex.h"
+
+using namespace std;
+
+class FlatHashMap : public FileIndex
+{
+public:
+	FlatHashMap();
+	~FlatHashMap();
+
+	void insert(Word* newWord);	//a word that is already in the table takes the new word's files, see FileIndex::insert
+	void printValues(int i);
+	void del(Word* deleteValue);
+	Word* find(string_view lookup);
+	int nonodes();
+	void clear();
+	void writeToFile(string fileName);
+	void getWords(vector<Word*>& words);
+	void bulkLoad(vector<Word*>& words);	//sized for the words once, each is placed without a lookup
+	int capacity();
+	int bytes();	//size of the slot and control arrays
+
+	static const int GROUP = 16;	//slots probed together, one SSE2 compare of their control bytes
+
+private:
+	static const signed char EMPTY = -128;
+	static const signed char DELETED = -2;	//a full control byte is the hash fragment, 0 to 127
+
+	struct Slot
+	{
+		unsigned long long prefix;	//letters 0-7 and 8-15 of the word, compared before the word itself is read
+		unsigned long long suffix;
+		Word* word;
+	};
+
+	static unsigned int match(const signed char* group, signed char control);	//bit i set when the group's i'th control byte equals control
+	static size_t hashOf(string_view key);
+	int findSlot(string_view key, size_t hash);	//-1 when the key isn't in the table
+	void place(Word* word, size_t hash);	//into the first free slot along the word's probe sequence
+	void rehash(int newGroups);
+
+	vector<signed char> controls;
+	vector<Slot> slots;
+	int groupMask;	//number of groups less one, the number of groups is a power of two
+	int size;
+	int tombstones;	//deleted slots, which still make probes go on past their group
+};
+
+#endif
@@ -8,44 +8,39 @@ HashMap::HashMap()
 }
 HashMap::~HashMap()
 {
-	//clear();
+	releaseWords();
 }
 void HashMap::insert(Word* newWord)
 {
-	if(table.empty())
-	{
-		table.insert(Hash::value_type(newWord->getWord(), newWord));
-	}
-	else if(table.find(newWord->getWord()) == table.end())
-		table.insert(Hash::value_type(newWord->getWord(), newWord));
+	invalidateDictionary();
+	Hash::iterator it = table.find(newWord->getKey());
+	if(it == table.end())
+		table.insert(Hash::value_type(newWord->getKey(), newWord));
 	else
-	{
-		Hash::iterator it = table.find(newWord->getWord());
-		vector<Word::File*> vec = newWord->getRanking();
-		Word* tempWord = it->second;
-		vector<Word::File*> tempRanking = tempWord->getRanking();
-		for(int i = 0; i < vec.size(); i++)
-		{
-			//it->second->getRanking().push_back(vec[i]);
-			tempRanking.push_back(vec[i]);
-		}
-	}
+		mergeWord(it->second, newWord);
 }
 void HashMap::printValues(int i)
 {
 	for(Hash::iterator it = table.begin(); it != table.end(); it++ )
 	{
-		cout << it->first << " " << it->second->getWord() << endl;
+		cout << it->first << " " << it->second->getKey() << endl;
 	}
 }
+//the word in the table with deleteNode's key is ended the way the structure ends its words, its memory may be the arena's
 void HashMap::del(Word* deleteNode)
 {
-	Hash::iterator it = table.find("hello");
-	if(it != table.end())
-		delete it->second;
-	table.erase(deleteNode->getWord());
+	invalidateDictionary();
+	Hash::iterator it = table.find(deleteNode->getKey());
+	if(it == table.end())
+	{
+		cout << "element not found" << endl;
+		return;
+	}
+	Word* word = it->second;
+	table.erase(it);	//before the word goes, the key views its text
+	destroyWord(word);
 }
-Word* HashMap::find(string lookup)
+Word* HashMap::find(string_view lookup)
 {
 	Hash::iterator it = table.find(lookup);
 	if(it != table.end())
@@ -63,45 +58,47 @@ int HashMap::nonodes()
 }
 void HashMap::clear()
 {
-	Hash::iterator it = table.begin();
-	while(it != table.end())
+	getDocuments().clear();
+	releaseWords();
+	table.clear();
+}
+void HashMap::bulkLoad(vector<Word*>& words)
+{
+	if(!table.empty())
+	{
+		FileIndex::bulkLoad(words);
+		return;
+	}
+	invalidateDictionary();
+	table.reserve(words.size());
+	for(int i = 0; i < words.size(); i++)
+		table.emplace_hint(table.end(), words[i]->getKey(), words[i]);
+}
+void HashMap::getWords(vector<Word*>& words)
+{
+	for(Hash::iterator it = table.begin(); it != table.end(); it++)
 	{
-		delete it->second;
-		table.erase(it->first);
-		++it;
+		words.push_back(it->second);
 	}
 }
 void HashMap::writeToFile(string fileName)
 {
 	ofstream outFile;
 	outFile.open(fileName.c_str());
-	int size = nonodes();
 	if(!outFile.is_open())
 	{
 		cerr << "file not found" << endl;
 	}
 	else
 	{
-		outFile << size << endl;                   //number of words total
-		Hash::iterator it = table.begin();
-		while(it != table.end())
-		{
-			outFile << it->second->getWord() << endl;              //prints the word
-			outFile << it->second->getTotalNumberDocuments() << endl;   //prints the number of files
-			vector<Word::File*> temp = it->second->getRanking();
-			for(int i = 0; i < temp.size(); i++)
-			{
-				outFile << temp[i]->fileName << endl;  //writes the filename to document
-				outFile << temp[i]->TFIDF << endl;      //TFIDF
-				outFile << temp[i]->numberOfAppearances << endl;  //number of appearances in that particular file
-				outFile << temp[i]->totalWordsInFile << endl;   //total words in the file
-				outFile << temp[i]->year << endl;	// year of post
-				outFile << temp[i]->strmonth << endl;	// month of post
-				outFile << temp[i]->day << endl;		// day of post
-			}
-			
-			it++;
-		}
+		writeHeader(outFile);                   //number of posts and number of words total
+		vector<Word*> words;
+		getWords(words);
+		sort(words.begin(), words.end(), Word::keyLess);	//the header says the words are sorted
+		for(int i = 0; i < words.size(); i++)
+			words[i]->write(outFile, storesPositions(), storesImpacts(), &getDocuments());
+		getDocuments().writeFields(outFile);   //headers shown with the results
 		outFile.close();
+		getDocuments().writeBodies(fileName + ".bodies");
 	}
 }
@@ -3,6 +3,7 @@
 
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include "Word.h"
 #include "FileIndex.h"
@@ -18,12 +19,14 @@ public:
 	void insert(Word* newWord);  //adds a value to hash map key represents value to be hashed value is a ptr to a dynamic word
 	void printValues(int i);               //prints values out no order does not handle buckets
 	void del(Word* deleteValue);
-	Word* find(string lookup);
+	Word* find(string_view lookup);
 	int nonodes();
 	void clear();
 	void writeToFile(string fileName);
+	void getWords(vector<Word*>& words);
+	void bulkLoad(vector<Word*>& words);	//sizes the table for the words once, then adds them without looking for duplicates
 private:
-	typedef unordered_map<string, Word*> Hash;
+	typedef unordered_map<string_view, Word*> Hash;	//the keys view the words' own text, which a word keeps while it is in the table
 	Hash table;
 };
 
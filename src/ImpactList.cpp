@@ -0,0 +1,132 @@
+/*File: ImpactList.cpp
+ *Project: Search Engine
+ *this file contains the functionality of ImpactList.h
+ */
+
+#include "ImpactList.h"
+#include "Word.h"
+#include "FileIndex.h"
+#include "Scorer.h"
+#include <algorithm>
+
+using namespace std;
+
+ImpactList::ImpactList()
+{
+	count = 0;
+	bits = 8;
+	step = 0;
+}
+void ImpactList::build(const vector<double>& scores, int newBits, double newStep)
+{
+	bits = newBits;
+	step = newStep;
+	count = scores.size();
+	impacts.clear();
+	impacts.reserve(count * bits / 8);
+	int levels = (1 << bits) - 1;
+	for(int i = 0; i < count; i++)
+	{
+		int level = 0;
+		if(step > 0)
+			level = (int)(scores[i] / step + 0.5);
+		if(level == 0 && scores[i] > 0)
+			level = 1;	//a matching post never rounds down to nothing
+		if(level > levels)
+			level = levels;
+		impacts += (char)(level & 0xFF);
+		if(bits == 16)
+			impacts += (char)(level >> 8);
+	}
+}
+void ImpactList::setLevels(const vector<int>& levels, int newBits, double newStep)
+{
+	bits = newBits;
+	step = newStep;
+	count = levels.size();
+	impacts.clear();
+	impacts.reserve(count * bits / 8);
+	for(int i = 0; i < count; i++)
+	{
+		impacts += (char)(levels[i] & 0xFF);
+		if(bits == 16)
+			impacts += (char)(levels[i] >> 8);
+	}
+}
+void ImpactList::decode(vector<double>& scores)
+{
+	scores.resize(count);
+	for(int i = 0; i < count; i++)
+		scores[i] = level(i) * step;
+}
+int ImpactList::level(int i)
+{
+	const unsigned char* levels = (const unsigned char*)impacts.data() + i * (bits / 8);
+	if(bits == 16)
+		return levels[0] | levels[1] << 8;
+	return levels[0];
+}
+double ImpactList::getStep()
+{
+	return step;
+}
+int ImpactList::getBits()
+{
+	return bits;
+}
+int ImpactList::size()
+{
+	return count;
+}
+int ImpactList::bytes()
+{
+	return impacts.size();
+}
+
+void ImpactList::quantizeIndex(FileIndex* index, Scorer* scorer, int bits, bool perWordScale)
+{
+	if(!scorer->isPreparedFor(index))
+		scorer->prepare(index);
+
+	TermDictionary* dictionary = index->getDictionary();
+	int levels = (1 << bits) - 1;
+	vector<vector<double> > scores(dictionary->size());
+	vector<double> maxScores(dictionary->size());
+	double globalMax = 0;
+
+	for(int i = 0; i < dictionary->size(); i++)	//exact scores first, the global scale needs the largest of them all
+	{
+		Word* word = dictionary->at(i);
+		const vector<int>& docIds = word->getDocIds();	//the dictionary froze the word, so these are in post id order
+		const vector<int>& frequencies = word->getFrequencies();
+		double weight = scorer->weight(word);
+		scores[i].resize(docIds.size());
+		maxScores[i] = 0;
+		for(int j = 0; j < docIds.size(); j++)
+		{
+			scores[i][j] = scorer->score(weight, frequencies[j], docIds[j]);
+			maxScores[i] = max(maxScores[i], scores[i][j]);
+		}
+		globalMax = max(globalMax, maxScores[i]);
+	}
+
+	for(int i = 0; i < dictionary->size(); i++)
+	{
+		double step = (perWordScale ? maxScores[i] : globalMax) / levels;
+		ImpactList* impacts = new ImpactList;
+		impacts->build(scores[i], bits, step);
+		for(int j = 0; j < impacts->size(); j++)
+			dictionary->at(i)->setScore(j, impacts->level(j) * impacts->getStep());	//no exact score is kept beside the impact
+		dictionary->at(i)->setImpacts(impacts);
+	}
+	index->setImpactScorer(scorer->getName(), bits);
+}
+void ImpactList::dropIndex(FileIndex* index)
+{
+	TermDictionary* dictionary = index->getDictionary();
+	for(int i = 0; i < dictionary->size(); i++)
+	{
+		dictionary->at(i)->setImpacts(NULL);
+	}
+	index->setImpactScorer("", 0);
+}
@@ -0,0 +1,46 @@
+/*File: ImpactList.h
+ *Project: Search Engine
+ *this file implements a compact copy of a word's scores for ranking: each posting's score rounded to
+ *an 8 or 16 bit step of a global or per word scale, in the word's post id order, so the post ids are
+ *the word's own. an index can be written with them in place of its exact scores
+ */
+
+#ifndef IMPACTLIST_H
+#define IMPACTLIST_H
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+class FileIndex;
+class Scorer;
+
+class ImpactList
+{
+public:
+	ImpactList();
+
+	void build(const vector<double>& scores, int bits, double step);	//scores in the word's post id order
+	void setLevels(const vector<int>& levels, int bits, double step);	//levels as read from an index file
+	void decode(vector<double>& scores);
+	int level(int i);
+	double getStep();
+	int getBits();
+	int size();
+	int bytes();                    //memory held by the impacts
+
+	//scores every posting of the index with the scorer and keeps the rounded impacts on each word.
+	//a global scale shares one step across all words, otherwise each word's best posting sets its own.
+	//the postings' exact scores are replaced by the rounded ones, the index is then written with impacts
+	static void quantizeIndex(FileIndex* index, Scorer* scorer, int bits, bool perWordScale);
+	static void dropIndex(FileIndex* index);
+
+private:
+	string impacts;                 //one or two bytes per posting, low byte first
+	int count;
+	int bits;
+	float step;                     //score of one quantization level
+};
+
+#endif
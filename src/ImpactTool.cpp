@@ -0,0 +1,114 @@
+/*File: ImpactTool.cpp
+ *Project: Search Engine
+ *this file measures what quantizing impact scores costs in ranking quality and saves in memory
+ *it runs every query of a query log (one query per line) against exact scores and then against
+ *8 and 16 bit impacts with a global and a per word scale, comparing the top k of each
+ *
+ *usage: ImpactTool <index file> <query log> [k]
+ */
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "HashMap.h"
+#include "SecondaryParser.h"
+#include "Parser.h"
+#include "QueryProcessor.h"
+#include "ImpactList.h"
+
+using namespace std;
+
+vector<vector<int> > runQueries(QueryProcessor& queryProcessor, vector<string>& queries, int k)
+{
+	vector<vector<int> > topK(queries.size());
+	for (int i = 0; i < queries.size(); i++)
+	{
+		queryProcessor.Query(queries[i]);
+		vector<QueryProcessor::Result> results = queryProcessor.getResults();
+		for (int j = 0; j < results.size() && j < k; j++)
+			topK[i].push_back(results[j].docId);
+	}
+	return topK;
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc < 3)
+	{
+		cerr << "usage: " << argv[0] << " <index file> <query log> [k]" << endl;
+		return 1;
+	}
+	int k = 10;
+	if (argc > 3)
+		k = atoi(argv[3]);
+
+	ifstream log(argv[2]);
+	if (!log.is_open())
+	{
+		cerr << "could not open query log " << argv[2] << endl;
+		return 1;
+	}
+	vector<string> queries;
+	string line;
+	while (getline(log, line))
+		if (line != "")
+			queries.push_back(line);
+
+	HashMap index;
+	SecondaryParser secondaryParser(&index);
+	secondaryParser.parseFile(argv[1]);
+	Parser parser;
+	QueryProcessor queryProcessor(&index, parser);
+
+	TermDictionary* dictionary = index.getDictionary();
+	long long postings = 0;
+	for (int i = 0; i < dictionary->size(); i++)
+		postings += dictionary->at(i)->getTotalNumberDocuments();
+
+	vector<vector<int> > exact = runQueries(queryProcessor, queries, k);
+
+	cout << queries.size() << " queries, " << postings << " postings, top " << k << ", scorer " << queryProcessor.getScorer()->getName() << endl;
+	cout << "exact: " << postings * sizeof(double) << " bytes (double score per posting, the impacts share the word's post ids)" << endl;
+	cout << endl;
+	cout << setw(6) << "bits" << setw(10) << "scale" << setw(14) << "bytes" << setw(12) << "overlap@k" << setw(12) << "same order" << endl;
+
+	int bits[] = { 8, 8, 16, 16 };
+	bool perWord[] = { false, true, false, true };
+	for (int c = 0; c < 4; c++)
+	{
+		ImpactList::quantizeIndex(&index, queryProcessor.getScorer(), bits[c], perWord[c]);
+		long long bytes = 0;
+		for (int i = 0; i < dictionary->size(); i++)
+			bytes += dictionary->at(i)->getImpacts()->bytes();
+
+		vector<vector<int> > quantized = runQueries(queryProcessor, queries, k);
+		double overlap = 0;
+		int sameOrder = 0;
+		int scored = 0;
+		for (int i = 0; i < queries.size(); i++)
+		{
+			if (exact[i].size() == 0)
+				continue;
+			int common = 0;
+			for (int j = 0; j < quantized[i].size(); j++)
+				if (find(exact[i].begin(), exact[i].end(), quantized[i][j]) != exact[i].end())
+					common++;
+			overlap += (double)common / exact[i].size();
+			if (quantized[i] == exact[i])
+				sameOrder++;
+			scored++;
+		}
+		if (scored == 0)
+			scored = 1;
+
+		cout << setw(6) << bits[c] << setw(10) << (perWord[c] ? "per word" : "global") << setw(14) << bytes
+		     << setw(12) << fixed << setprecision(4) << overlap / scored
+		     << setw(12) << (double)sameOrder / scored << endl;
+	}
+	ImpactList::dropIndex(&index);
+
+	return 0;
+}
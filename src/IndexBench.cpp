@@ -0,0 +1,317 @@
+/*File: IndexBench.cpp
+ *Project: Search Engine
+ *this file times word lookups in each index structure. the words are inserted in random order, then
+ *looked up in another random order, and for every structure it prints the time per insert and per
+ *lookup, the heap the structure itself takes per word, the heap allocations per lookup and, where the
+ *processor's counters can be read, the cache misses per lookup
+ *
+ *usage: IndexBench [number of words] [lookups] [index file] [query file]
+ *with an index file its words are used instead of made up ones. with a query file too, one query a
+ *line, the queries are run against the index loaded into each structure, counting the allocations
+ *made per query and per query word, the word's stemming and lookup
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <set>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <stdlib.h>
+#include "FileIndex.h"
+#include "SecondaryParser.h"
+#include "QueryProcessor.h"
+#include <fstream>
+#include <sstream>
+#include <new>
+
+#if defined (__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+	#include <malloc.h>
+	#define INDEXBENCH_MALLINFO
+#endif
+#if defined (__linux__)
+	#include <linux/perf_event.h>
+	#include <sys/ioctl.h>
+	#include <sys/syscall.h>
+	#include <unistd.h>
+	#include <string.h>
+#endif
+
+using namespace std;
+
+// every operator new in the program is counted, the benchmark runs on one thread
+long long allocations = 0;
+
+void* operator new(size_t size)
+{
+	allocations++;
+	void* memory = malloc(size == 0 ? 1 : size);
+	if (memory == NULL)
+		throw bad_alloc();
+	return memory;
+}
+
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+	free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+	free(memory);
+}
+
+// the sized forms the compiler calls when it knows the size have to free the same way
+void operator delete(void* memory, size_t) noexcept
+{
+	free(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept
+{
+	free(memory);
+}
+
+// counts this thread's misses in the first level data cache or in the last level cache, -1 when the kernel won't give us a counter
+int openCounter(bool firstLevel)
+{
+	#if defined (__linux__)
+		perf_event_attr attr;
+		memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = firstLevel ? PERF_TYPE_HW_CACHE : PERF_TYPE_HARDWARE;
+		attr.config = firstLevel ? PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)
+			: PERF_COUNT_HW_CACHE_MISSES;
+		attr.disabled = 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		return syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+	#else
+		return -1;
+	#endif
+}
+
+void startCounter(int counter)
+{
+	#if defined (__linux__)
+		if (counter >= 0)
+		{
+			ioctl(counter, PERF_EVENT_IOC_RESET, 0);
+			ioctl(counter, PERF_EVENT_IOC_ENABLE, 0);
+		}
+	#endif
+}
+
+long long stopCounter(int counter)
+{
+	long long count = -1;
+	#if defined (__linux__)
+		if (counter >= 0)
+		{
+			ioctl(counter, PERF_EVENT_IOC_DISABLE, 0);
+			if (read(counter, &count, sizeof(count)) != sizeof(count))
+				count = -1;
+		}
+	#endif
+	return count;
+}
+
+void closeCounter(int counter)
+{
+	#if defined (__linux__)
+		if (counter >= 0)
+			close(counter);
+	#endif
+}
+
+// bytes of heap in use, -1 where the C library doesn't say
+long long heapInUse()
+{
+	#if defined (INDEXBENCH_MALLINFO)
+		return mallinfo2().uordblks + mallinfo2().hblkhd;	// large blocks are mapped on their own and counted apart
+	#else
+		return -1;
+	#endif
+}
+
+vector<string> madeUpWords(int count, mt19937& random)
+{
+	set<string> words;
+	uniform_int_distribution<int> length(3, 12);
+	uniform_int_distribution<int> letter('a', 'z');
+	while (words.size() < count)
+	{
+		string word(length(random), ' ');
+		for (int i = 0; i < word.size(); i++)
+			word[i] = letter(random);
+		words.insert(word);
+	}
+	return vector<string>(words.begin(), words.end());
+}
+
+vector<string> indexWords(string fileName)
+{
+	FileIndex* index = FileIndex::create("HashMap");
+	SecondaryParser parser(index);
+	parser.parseFile(fileName);
+	vector<Word*> words;
+	index->getWords(words);
+	vector<string> names;
+	for (int i = 0; i < words.size(); i++)
+		names.push_back(words[i]->getWord());
+	delete index;
+	return names;
+}
+
+vector<string> queryLines(string fileName)
+{
+	ifstream in(fileName.c_str());
+	vector<string> queries;
+	string line;
+	while (getline(in, line))
+		if (line != "")
+			queries.push_back(line);
+	return queries;
+}
+
+void printCount(long long count, int per)
+{
+	if (count < 0)
+		cout << setw(14) << "n/a";
+	else
+		cout << setw(14) << (double)count / per;
+}
+
+/*
+ *each query is run once first, so what is built on first use (the dictionary, bitmaps, the suggester)
+ *and vectors that keep their size from query to query are not counted. the words are split out of the
+ *queries before the counting starts
+ */
+void runQueries(string indexFile, const vector<string>& queries, string types[], int numberOfTypes)
+{
+	vector<string> terms;
+	for (int i = 0; i < queries.size(); i++)
+	{
+		stringstream query(queries[i]);
+		string term;
+		while (query >> term)
+			if (isalpha(term[0]))
+				terms.push_back(term);
+	}
+
+	cout << endl;
+	cout << queries.size() << " queries, " << terms.size() << " query words" << endl;
+	cout << endl;
+	cout << setw(16) << "structure" << setw(14) << "query us" << setw(14) << "allocations" << setw(14) << "word ns"
+		<< setw(14) << "allocations" << endl;
+	for (int t = 0; t < numberOfTypes; t++)
+	{
+		FileIndex* index = FileIndex::create(types[t]);
+		SecondaryParser loader(index);
+		loader.parseFile(indexFile);
+		Parser parser;
+		QueryProcessor processor(index, parser);
+		for (int i = 0; i < queries.size(); i++)
+			processor.Query(queries[i]);
+
+		long long allocationsBefore = allocations;
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		for (int i = 0; i < queries.size(); i++)
+			processor.Query(queries[i]);
+		double queryTime = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count() / queries.size();
+		long long queryAllocations = allocations - allocationsBefore;
+
+		allocationsBefore = allocations;
+		start = chrono::steady_clock::now();
+		for (int i = 0; i < terms.size(); i++)
+			index->find(parser.stemWord(terms[i]));
+		double termTime = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / terms.size();
+		long long termAllocations = allocations - allocationsBefore;
+
+		cout << setw(16) << types[t] << fixed << setprecision(1) << setw(14) << queryTime;
+		printCount(queryAllocations, queries.size());
+		cout << setw(14) << termTime;
+		printCount(termAllocations, terms.size());
+		cout << endl;
+		delete index;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	int numberOfWords = 200000;
+	int lookups = 1000000;
+	if (argc > 1)
+		numberOfWords = atoi(argv[1]);
+	if (argc > 2)
+		lookups = atoi(argv[2]);
+
+	mt19937 random(42);
+	vector<string> words = argc > 3 ? indexWords(argv[3]) : madeUpWords(numberOfWords, random);
+	shuffle(words.begin(), words.end(), random);
+	vector<string> keys(lookups);
+	uniform_int_distribution<int> pick(0, words.size() - 1);
+	for (int i = 0; i < lookups; i++)
+		keys[i] = words[pick(random)];
+
+	int cacheMisses = openCounter(false);
+	int l1Misses = openCounter(true);
+
+	cout << words.size() << " words, " << lookups << " lookups of words in the index" << endl;
+	cout << endl;
+	cout << setw(16) << "structure" << setw(14) << "insert ns" << setw(14) << "lookup ns" << setw(14) << "bytes/word"
+		<< setw(14) << "allocations" << setw(14) << "L1 misses" << setw(14) << "LLC misses" << endl;
+
+	string types[] = { "AVL", "HashMap", "BTree", "FlatHashMap", "ART", "PerfectHashMap" };
+	for (int t = 0; t < 6; t++)
+	{
+		FileIndex* index = FileIndex::create(types[t]);
+		vector<Word*> newWords(words.size());	//made first so only the structure's own memory is counted
+		for (int i = 0; i < words.size(); i++)
+			newWords[i] = index->newWord(words[i]);
+		long long heapBefore = heapInUse();
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		for (int i = 0; i < words.size(); i++)
+			index->insert(newWords[i]);
+		index->find(words[0]);	//a structure that builds its lookup on first use, like PerfectHashMap, builds it here
+		double insertTime = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / words.size();
+		long long heapUsed = heapInUse() - heapBefore;
+
+		int found = 0;
+		long long allocationsBefore = allocations;
+		startCounter(cacheMisses);
+		startCounter(l1Misses);
+		start = chrono::steady_clock::now();
+		for (int i = 0; i < lookups; i++)
+			found += index->find(keys[i]) != NULL;
+		double lookupTime = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / lookups;
+		long long l1 = stopCounter(l1Misses);
+		long long llc = stopCounter(cacheMisses);
+		long long lookupAllocations = allocations - allocationsBefore;
+
+		cout << setw(16) << types[t] << fixed << setprecision(1) << setw(14) << insertTime << setw(14) << lookupTime;
+		printCount(heapBefore < 0 ? -1 : heapUsed, words.size());
+		printCount(lookupAllocations, lookups);
+		printCount(l1, lookups);
+		printCount(llc, lookups);
+		cout << endl;
+		if (found != lookups)
+			cout << "  only " << found << " of the words were found" << endl;
+
+		delete index;	//the words go with it
+	}
+
+	closeCounter(cacheMisses);
+	closeCounter(l1Misses);
+
+	if (argc > 4)
+		runQueries(argv[3], queryLines(argv[4]), types, 6);
+	return 0;
+}
@@ -0,0 +1,111 @@
+/*File: IntersectBench.cpp
+ *Project: Search Engine
+ *this file times the post id intersection kernels against the plain merge. for each ratio between
+ *the list sizes it builds two random ascending lists, checks every kernel finds the same ids as the
+ *merge and prints the time per intersection and the speed up over the merge
+ *
+ *usage: IntersectBench [size of the long list] [repetitions]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <set>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <stdlib.h>
+#include "Intersection.h"
+
+using namespace std;
+
+vector<int> randomList(int size, int universe, mt19937& random)
+{
+	set<int> ids;
+	uniform_int_distribution<int> pick(0, universe - 1);
+	while (ids.size() < size)
+		ids.insert(pick(random));
+	return vector<int>(ids.begin(), ids.end());
+}
+
+// microseconds for one run of the kernel, averaged over the repetitions
+double timeKernel(Intersection::Kernel kernel, vector<int>& a, vector<int>& b, vector<int>& out, int repetitions, int& found)
+{
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	for (int i = 0; i < repetitions; i++)
+		found = kernel(&a[0], a.size(), &b[0], b.size(), &out[0]);
+	return chrono::duration<double, micro>(chrono::steady_clock::now() - start).count() / repetitions;
+}
+
+double timeBlocks(Intersection::BlockList& a, Intersection::BlockList& b, vector<int>& out, int repetitions, int& found)
+{
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	for (int i = 0; i < repetitions; i++)
+		found = Intersection::intersect(a, b, &out[0]);
+	return chrono::duration<double, micro>(chrono::steady_clock::now() - start).count() / repetitions;
+}
+
+int main(int argc, char* argv[])
+{
+	int longSize = 1 << 18;
+	int repetitions = 50;
+	if (argc > 1)
+		longSize = atoi(argv[1]);
+	if (argc > 2)
+		repetitions = atoi(argv[2]);
+
+	mt19937 random(42);
+	string names[] = { "scalar", "sse4.2", "avx2" };
+	cout << "best kernel on this processor: " << Intersection::getKernelName() << endl;
+	cout << "long list: " << longSize << " ids, times in microseconds per intersection" << endl;
+	cout << endl;
+	cout << setw(6) << "ratio" << setw(10) << "found" << setw(12) << "scalar" << setw(12) << "sse4.2" << setw(12) << "avx2"
+		<< setw(12) << "gallop" << setw(12) << "blocks" << setw(12) << "dispatch" << endl;
+
+	bool allMatch = true;
+	for (int ratio = 1; ratio <= 1024 && longSize / ratio > 0; ratio *= 4)
+	{
+		vector<int> shortList = randomList(longSize / ratio, longSize * 4, random);
+		vector<int> longList = randomList(longSize, longSize * 4, random);
+		vector<int> out(shortList.size());
+		vector<int> expected(shortList.size());
+		int expectedCount = Intersection::scalar(&shortList[0], shortList.size(), &longList[0], longList.size(), &expected[0]);
+
+		cout << setw(6) << ratio << setw(10) << expectedCount << fixed << setprecision(1);
+		for (int k = 0; k < 3; k++)
+		{
+			Intersection::Kernel kernel = Intersection::getKernel(names[k]);
+			if (kernel == NULL)
+			{
+				cout << setw(12) << "-";
+				continue;
+			}
+			int found = 0;
+			double time = timeKernel(kernel, shortList, longList, out, repetitions, found);
+			if (found != expectedCount || !equal(out.begin(), out.begin() + found, expected.begin()))
+				allMatch = false;
+			cout << setw(12) << time;
+		}
+
+		int found = 0;
+		double time = timeKernel(Intersection::gallop, shortList, longList, out, repetitions, found);
+		allMatch = allMatch && found == expectedCount;
+		cout << setw(12) << time;
+
+		Intersection::BlockList shortBlocks, longBlocks;
+		shortBlocks.build(shortList);
+		longBlocks.build(longList);
+		time = timeBlocks(shortBlocks, longBlocks, out, repetitions, found);
+		allMatch = allMatch && found == expectedCount;
+		cout << setw(12) << time;
+
+		time = timeKernel(Intersection::intersect, shortList, longList, out, repetitions, found);
+		allMatch = allMatch && found == expectedCount;
+		cout << setw(12) << time << endl;
+	}
+
+	cout << endl;
+	cout << (allMatch ? "every kernel matched the merge" : "MISMATCH: a kernel disagreed with the merge") << endl;
+	return allMatch ? 0 : 1;
+}
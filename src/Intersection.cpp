@@ -0,0 +1,265 @@
+/*File: Intersection.cpp
+ *Project: Search Engine
+ *this file contains the functionality of Intersection.h
+ */
+
+#include "Intersection.h"
+
+#if (defined (__GNUC__) || defined (__clang__)) && (defined (__x86_64__) || defined (__i386__))
+	#define INTERSECTION_X86
+	#include <immintrin.h>
+#endif
+
+using namespace std;
+
+/*
+ *the vector kernels each take a block of ids from both lists and compare every id of the first
+ *block with every rotation of the second, so any id present in both lines up with its match once.
+ *the block with the smaller last id is used up and the next one is loaded, when the last ids are
+ *equal both are. the ids left over after the last full blocks are merged one at a time
+ */
+
+int Intersection::scalar(const int* a, int aSize, const int* b, int bSize, int* out)
+{
+	int count = 0;
+	int i = 0;
+	int j = 0;
+	while (i < aSize && j < bSize)
+	{
+		if (a[i] < b[j])
+			i++;
+		else if (b[j] < a[i])
+			j++;
+		else
+		{
+			out[count++] = a[i];
+			i++;
+			j++;
+		}
+	}
+	return count;
+}
+
+/**
+	gallop looks each id of the short list up in the long one, doubling the step
+	from the last match until it passes the id and then binary searching that step
+**/
+int Intersection::gallop(const int* a, int aSize, const int* b, int bSize, int* out)
+{
+	int count = 0;
+	int low = 0;
+	for (int i = 0; i < aSize && low < bSize; i++)
+	{
+		int target = a[i];
+		int step = 1;
+		int high = low;
+		while (high < bSize && b[high] < target)
+		{
+			low = high + 1;
+			high += step;
+			step *= 2;
+		}
+		if (high > bSize)
+			high = bSize;
+		while (low < high)     // first id >= target in b[low, high]
+		{
+			int middle = (low + high) / 2;
+			if (b[middle] < target)
+				low = middle + 1;
+			else
+				high = middle;
+		}
+		if (low < bSize && b[low] == target)
+			out[count++] = b[low++];
+	}
+	return count;
+}
+
+#if defined (INTERSECTION_X86)
+
+__attribute__((target("sse4.2")))
+int Intersection::sse42(const int* a, int aSize, const int* b, int bSize, int* out)
+{
+	int count = 0;
+	int i = 0;
+	int j = 0;
+	while (i + 4 <= aSize && j + 4 <= bSize)
+	{
+		__m128i blockA = _mm_loadu_si128((const __m128i*)(a + i));
+		__m128i blockB = _mm_loadu_si128((const __m128i*)(b + j));
+		__m128i equal = _mm_cmpeq_epi32(blockA, blockB);
+		equal = _mm_or_si128(equal, _mm_cmpeq_epi32(blockA, _mm_shuffle_epi32(blockB, _MM_SHUFFLE(0, 3, 2, 1))));
+		equal = _mm_or_si128(equal, _mm_cmpeq_epi32(blockA, _mm_shuffle_epi32(blockB, _MM_SHUFFLE(1, 0, 3, 2))));
+		equal = _mm_or_si128(equal, _mm_cmpeq_epi32(blockA, _mm_shuffle_epi32(blockB, _MM_SHUFFLE(2, 1, 0, 3))));
+
+		int found = _mm_movemask_ps(_mm_castsi128_ps(equal));
+		while (found != 0)
+		{
+			out[count++] = a[i + __builtin_ctz(found)];
+			found &= found - 1;
+		}
+
+		int lastA = a[i + 3];
+		int lastB = b[j + 3];
+		if (lastA <= lastB)
+			i += 4;
+		if (lastB <= lastA)
+			j += 4;
+	}
+	return count + scalar(a + i, aSize - i, b + j, bSize - j, out + count);
+}
+
+__attribute__((target("avx2")))
+int Intersection::avx2(const int* a, int aSize, const int* b, int bSize, int* out)
+{
+	int count = 0;
+	int i = 0;
+	int j = 0;
+	const __m256i rotate = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+	while (i + 8 <= aSize && j + 8 <= bSize)
+	{
+		__m256i blockA = _mm256_loadu_si256((const __m256i*)(a + i));
+		__m256i blockB = _mm256_loadu_si256((const __m256i*)(b + j));
+		__m256i equal = _mm256_cmpeq_epi32(blockA, blockB);
+		for (int r = 1; r < 8; r++)
+		{
+			blockB = _mm256_permutevar8x32_epi32(blockB, rotate);
+			equal = _mm256_or_si256(equal, _mm256_cmpeq_epi32(blockA, blockB));
+		}
+
+		int found = _mm256_movemask_ps(_mm256_castsi256_ps(equal));
+		while (found != 0)
+		{
+			out[count++] = a[i + __builtin_ctz(found)];
+			found &= found - 1;
+		}
+
+		int lastA = a[i + 7];
+		int lastB = b[j + 7];
+		if (lastA <= lastB)
+			i += 8;
+		if (lastB <= lastA)
+			j += 8;
+	}
+	return count + scalar(a + i, aSize - i, b + j, bSize - j, out + count);
+}
+
+bool Intersection::isSupported(string name)
+{
+	__builtin_cpu_init();
+	if (name == "scalar")
+		return true;
+	if (name == "sse4.2")
+		return __builtin_cpu_supports("sse4.2");
+	if (name == "avx2")
+		return __builtin_cpu_supports("avx2");
+	return false;
+}
+
+#else
+
+// without x86 intrinsics the vector kernels fall back to the merge and are never picked
+int Intersection::sse42(const int* a, int aSize, const int* b, int bSize, int* out)
+{
+	return scalar(a, aSize, b, bSize, out);
+}
+
+int Intersection::avx2(const int* a, int aSize, const int* b, int bSize, int* out)
+{
+	return scalar(a, aSize, b, bSize, out);
+}
+
+bool Intersection::isSupported(string name)
+{
+	return name == "scalar";
+}
+
+#endif
+
+Intersection::Kernel Intersection::getKernel(string name)
+{
+	if (!isSupported(name))
+		return NULL;
+	if (name == "avx2")
+		return avx2;
+	if (name == "sse4.2")
+		return sse42;
+	return scalar;
+}
+
+bool Intersection::setKernel(string name)
+{
+	Kernel chosen = getKernel(name);
+	if (chosen == NULL)
+		return false;
+	kernel = chosen;
+	kernelName = name;
+	return true;
+}
+
+string Intersection::getKernelName()
+{
+	return kernelName;
+}
+
+string bestKernel()
+{
+	if (Intersection::isSupported("avx2"))
+		return "avx2";
+	if (Intersection::isSupported("sse4.2"))
+		return "sse4.2";
+	return "scalar";
+}
+
+string Intersection::kernelName = bestKernel();
+Intersection::Kernel Intersection::kernel = Intersection::getKernel(Intersection::kernelName);
+
+int Intersection::intersect(const int* a, int aSize, const int* b, int bSize, int* out)
+{
+	if (aSize == 0 || bSize == 0)
+		return 0;
+	if (aSize > bSize * GALLOP_RATIO)
+		return gallop(b, bSize, a, aSize, out);
+	if (bSize > aSize * GALLOP_RATIO)
+		return gallop(a, aSize, b, bSize, out);
+	return kernel(a, aSize, b, bSize, out);
+}
+
+void Intersection::BlockList::build(const vector<int>& ascending)
+{
+	ids = ascending;
+	blockLast.clear();
+	for (int i = BLOCK_SIZE - 1; i < ids.size(); i += BLOCK_SIZE)
+		blockLast.push_back(ids[i]);
+	if (ids.size() % BLOCK_SIZE != 0)
+		blockLast.push_back(ids.back());
+}
+
+/**
+	intersect for block lists pairs up the blocks whose ranges overlap, judged
+	by their last ids, and only runs the kernel on those pairs
+**/
+int Intersection::intersect(const BlockList& a, const BlockList& b, int* out)
+{
+	int count = 0;
+	int i = 0;
+	int j = 0;
+	while (i < a.blockLast.size() && j < b.blockLast.size())
+	{
+		int aStart = i * BLOCK_SIZE;
+		int bStart = j * BLOCK_SIZE;
+		int aEnd = aStart + BLOCK_SIZE < a.ids.size() ? aStart + BLOCK_SIZE : a.ids.size();
+		int bEnd = bStart + BLOCK_SIZE < b.ids.size() ? bStart + BLOCK_SIZE : b.ids.size();
+
+		if (a.blockLast[i] >= b.ids[bStart] && b.blockLast[j] >= a.ids[aStart])
+			count += kernel(&a.ids[aStart], aEnd - aStart, &b.ids[bStart], bEnd - bStart, out + count);
+
+		int lastA = a.blockLast[i];
+		int lastB = b.blockLast[j];
+		if (lastA <= lastB)
+			i++;
+		if (lastB <= lastA)
+			j++;
+	}
+	return count;
+}
@@ -0,0 +1,51 @@
+/*File: Intersection.h
+ *Project: Search Engine
+ *this file implements the intersection of two ascending lists of post ids, the inner loop of AND
+ *there is a plain merge, and SSE4.2 and AVX2 versions that compare 4 or 8 ids of one list against
+ *4 or 8 of the other at once. the fastest one the processor supports is picked when the program
+ *starts. when one list is much longer than the other the short one gallops through the long one
+ */
+
+#ifndef INTERSECTION_H
+#define INTERSECTION_H
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+class Intersection
+{
+public:
+	//writes the ids found in both a and b to out, which needs room for the shorter list, and returns how many
+	typedef int (*Kernel)(const int* a, int aSize, const int* b, int bSize, int* out);
+
+	static const int BLOCK_SIZE = 128;
+	static const int GALLOP_RATIO = 32;     //lists this many times longer than the other are galloped through
+
+	//ids cut into blocks of BLOCK_SIZE with each block's last id, so blocks that can't overlap are skipped
+	struct BlockList {
+		vector<int> ids;
+		vector<int> blockLast;
+		void build(const vector<int>& ascending);
+	};
+
+	static int intersect(const int* a, int aSize, const int* b, int bSize, int* out);
+	static int intersect(const BlockList& a, const BlockList& b, int* out);
+
+	static int scalar(const int* a, int aSize, const int* b, int bSize, int* out);
+	static int gallop(const int* a, int aSize, const int* b, int bSize, int* out);     //a the short list
+	static int sse42(const int* a, int aSize, const int* b, int bSize, int* out);
+	static int avx2(const int* a, int aSize, const int* b, int bSize, int* out);
+
+	static bool isSupported(string name);   //"scalar", "sse4.2" or "avx2"
+	static Kernel getKernel(string name);   //NULL if the name is unknown or the processor can't run it
+	static bool setKernel(string name);     //for comparing the kernels, the best supported one is used otherwise
+	static string getKernelName();
+
+private:
+	static Kernel kernel;
+	static string kernelName;
+};
+
+#endif
@@ -0,0 +1,183 @@
+/*File: LineSocket.cpp
+ *Project: Search Engine
+ *this file contains the functionality of LineSocket.h
+ */
+
+#include "LineSocket.h"
+#include <iostream>
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined (_MSC_VER)
+	#include <errno.h>
+	#include <unistd.h>
+	#include <sys/socket.h>
+	#include <sys/un.h>
+	#include <netinet/in.h>
+	#include <arpa/inet.h>
+#endif
+
+using namespace std;
+
+bool isPort(const string& address)
+{
+	if (address.size() == 0)
+		return false;
+	for (int i = 0; i < address.size(); i++)
+		if (!isdigit(address[i]))
+			return false;
+	return true;
+}
+
+LineSocket::LineSocket(int descriptor)
+{
+	descriptor_ = descriptor;
+}
+
+#if defined (_MSC_VER)
+
+LineSocket::~LineSocket() {}
+bool LineSocket::readLine(string& line) { return false; }
+bool LineSocket::write(const string& text) { return false; }
+void LineSocket::shutdownWrites() {}
+void LineSocket::disconnect() {}
+LineSocket* LineSocket::connectTo(string address) { cerr << "sockets are not supported on this platform" << endl; return NULL; }
+int LineSocket::listenOn(string address) { cerr << "sockets are not supported on this platform" << endl; return -1; }
+LineSocket* LineSocket::acceptFrom(int listener) { return NULL; }
+void LineSocket::closeListener(int listener, string address) {}
+
+#else
+
+LineSocket::~LineSocket()
+{
+	close(descriptor_);
+}
+
+bool LineSocket::readLine(string& line)
+{
+	while (true)
+	{
+		size_t end = pending_.find('\n');
+		if (end != string::npos)
+		{
+			line = pending_.substr(0, end);
+			pending_.erase(0, end + 1);
+			return true;
+		}
+		char buffer[4096];
+		ssize_t received = recv(descriptor_, buffer, sizeof(buffer), 0);
+		if (received <= 0)
+			return false;
+		pending_.append(buffer, received);
+	}
+}
+
+bool LineSocket::write(const string& text)
+{
+	size_t sent = 0;
+	while (sent < text.size())
+	{
+		ssize_t count = send(descriptor_, text.data() + sent, text.size() - sent, MSG_NOSIGNAL);
+		if (count <= 0)
+			return false;
+		sent += count;
+	}
+	return true;
+}
+
+void LineSocket::shutdownWrites()
+{
+	shutdown(descriptor_, SHUT_WR);
+}
+
+void LineSocket::disconnect()
+{
+	shutdown(descriptor_, SHUT_RDWR);
+}
+
+LineSocket* LineSocket::connectTo(string address)
+{
+	int descriptor;
+	int connected;
+	if (isPort(address))
+	{
+		descriptor = socket(AF_INET, SOCK_STREAM, 0);
+		sockaddr_in inet;
+		memset(&inet, 0, sizeof(inet));
+		inet.sin_family = AF_INET;
+		inet.sin_port = htons(atoi(address.c_str()));
+		inet.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		connected = connect(descriptor, (sockaddr*)&inet, sizeof(inet));
+	}
+	else
+	{
+		descriptor = socket(AF_UNIX, SOCK_STREAM, 0);
+		sockaddr_un local;
+		memset(&local, 0, sizeof(local));
+		local.sun_family = AF_UNIX;
+		strncpy(local.sun_path, address.c_str(), sizeof(local.sun_path) - 1);
+		connected = connect(descriptor, (sockaddr*)&local, sizeof(local));
+	}
+	if (descriptor < 0 || connected < 0)
+	{
+		if (descriptor >= 0)
+			close(descriptor);
+		return NULL;
+	}
+	return new LineSocket(descriptor);
+}
+
+int LineSocket::listenOn(string address)
+{
+	int descriptor;
+	int bound;
+	if (isPort(address))
+	{
+		descriptor = socket(AF_INET, SOCK_STREAM, 0);
+		int reuse = 1;
+		setsockopt(descriptor, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+		sockaddr_in inet;
+		memset(&inet, 0, sizeof(inet));
+		inet.sin_family = AF_INET;
+		inet.sin_port = htons(atoi(address.c_str()));
+		inet.sin_addr.s_addr = htonl(INADDR_LOOPBACK);	// never reachable from other machines
+		bound = bind(descriptor, (sockaddr*)&inet, sizeof(inet));
+	}
+	else
+	{
+		descriptor = socket(AF_UNIX, SOCK_STREAM, 0);
+		sockaddr_un local;
+		memset(&local, 0, sizeof(local));
+		local.sun_family = AF_UNIX;
+		strncpy(local.sun_path, address.c_str(), sizeof(local.sun_path) - 1);
+		unlink(address.c_str());	// left behind by a daemon that didn't shut down cleanly
+		bound = bind(descriptor, (sockaddr*)&local, sizeof(local));
+	}
+	if (descriptor < 0 || bound < 0 || listen(descriptor, 64) < 0)
+	{
+		if (descriptor >= 0)
+			close(descriptor);
+		return -1;
+	}
+	return descriptor;
+}
+
+LineSocket* LineSocket::acceptFrom(int listener)
+{
+	int descriptor = accept(listener, NULL, NULL);
+	while (descriptor < 0 && (errno == EINTR || errno == ECONNABORTED))	// a signal, or a client that left before it was accepted
+		descriptor = accept(listener, NULL, NULL);
+	if (descriptor < 0)
+		return NULL;
+	return new LineSocket(descriptor);
+}
+
+void LineSocket::closeListener(int listener, string address)
+{
+	shutdown(listener, SHUT_RDWR);	// wakes up a thread blocked in accept
+	close(listener);
+	if (!isPort(address))
+		unlink(address.c_str());
+}
+
+#endif
@@ -0,0 +1,36 @@
+/*File: LineSocket.h
+ *Project: Search Engine
+ *this file implements a connected stream socket that is read and written one line at a time
+ *an address made only of digits is a TCP port on 127.0.0.1, anything else is the path of a
+ *unix domain socket. sockets aren't supported on windows builds
+ */
+
+#ifndef LINESOCKET_H
+#define LINESOCKET_H
+
+#include <string>
+
+using namespace std;
+
+class LineSocket
+{
+public:
+	LineSocket(int descriptor);
+	~LineSocket();                                  //closes the connection
+
+	bool readLine(string& line);                    //false once the other side has closed
+	bool write(const string& text);
+	void shutdownWrites();                          //tells the other side nothing more is coming
+	void disconnect();                              //ends a readLine blocked in another thread
+
+	static LineSocket* connectTo(string address);   //NULL when nothing is listening there
+	static int listenOn(string address);            //listening descriptor, -1 on failure
+	static LineSocket* acceptFrom(int listener);    //NULL once the listener is closed, interrupted and aborted accepts are retried
+	static void closeListener(int listener, string address);
+
+private:
+	int descriptor_;
+	string pending_;                                //bytes read past the end of the last line
+};
+
+#endif
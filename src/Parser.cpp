@@ -19,6 +19,7 @@
 Parser::Parser()
 {
 	filesAreParsed_ = false;
+	storePositions_ = false;
 	numberOfFiles_ = 0;
 	inputFilePath_ = "";
 
@@ -47,6 +48,7 @@ Parser::~Parser()
 void Parser::parseFile(string fullFileName)
 {
 		vector<Word*> tempWordList;
+		vector<vector<int> > tempPositions;	// body offsets of each word in tempWordList
 		int numberOfWords = 0;
 
 		fstream myFile;
@@ -70,12 +72,20 @@ void Parser::parseFile(string fullFileName)
 
 		bool dateChecked = false;
 
+		vector<string> fields(DocumentTable::NUMBER_OF_FIELDS);	// headers stored with the post so results don't reopen it
+		string body = "";
+		vector<int> tokenOffsets;
+
 		while (!myFile.eof())
 		{
 			string tempLine = "";
 			getline(myFile, tempLine);
 			string tempWord = "";
 
+			int field = DocumentTable::headerField(tempLine);
+			if (field != -1 && fields[field] == "")
+				fields[field] = DocumentTable::headerValue(tempLine);
+
 			switch (fieldCount)	// this is to help determine what metadata is currently laoded, and proceed properly
 			{
 				case 1 :
@@ -130,22 +140,44 @@ void Parser::parseFile(string fullFileName)
 
 			if (fieldCount == 3)
 			{
-				while (!myFile.eof())
+				int position = 0;	// offset of the word in the body, stop words are counted so phrases keep their spacing
+
+				string bodyLine = "";
+				while (getline(myFile, bodyLine))
+					body += bodyLine + "\n";
+
+				for (int start = 0; start < body.size(); start++)
 				{
-					myFile >> tempWord;
+					if (isspace((unsigned char)body[start]))
+						continue;
+					int end = start;
+					while (end < body.size() && !isspace((unsigned char)body[end]))
+						end++;
+					tempWord = body.substr(start, end - start);
+					tokenOffsets.push_back(start);	// kept with the body so snippets can find words without reading the post
+					start = end;
 
 					bool isStop = checkStopWord(tempWord);
 	
 					if (!isStop)
 					{
 						Word* tempWordWord = getWord(tempWord, fullFileName, day, month, year);
-						bool wordExists = doesWordExist(tempWordWord, tempWordList);
+						int wordIndex = findWordIndex(tempWordWord, tempWordList);
 
-						if (!wordExists)
+						if (wordIndex == -1)
+						{
 							tempWordList.push_back(tempWordWord);	// vector of words specific to file, allows for manipulation
+							tempPositions.push_back(vector<int>());
+							wordIndex = tempWordList.size() - 1;
+						}
+
+						if (storePositions_)
+							tempPositions[wordIndex].push_back(position);
 
 						numberOfWords++;
 					}
+
+					position++;
 				}
 			}
 
@@ -155,8 +187,36 @@ void Parser::parseFile(string fullFileName)
 
 		myFile.close();
 
+		if (validFile)	// header terms are added once the date is known, From comes before Date in most posts
+		{
+			for (int i = 0; i < DocumentTable::NUMBER_OF_FIELDS; i++)
+			{
+				vector<string> terms = fieldTerms(i, fields[i]);
+				for (int j = 0; j < terms.size(); j++)
+				{
+					Word* tempWordWord = getTerm(terms[j], fullFileName, day, month, year);
+					if (findWordIndex(tempWordWord, tempWordList) == -1)
+					{
+						tempWordList.push_back(tempWordWord);
+						tempPositions.push_back(vector<int>());
+					}
+				}
+			}
+		}
+
+		if (validFile)
+		{
+			int docId = storedPosts_.add(fullFileName, numberOfWords, year, 0, month, day);
+			storedPosts_.setFields(docId, fields);
+			if (storePositions_)
+				storedPosts_.setBody(docId, body, tokenOffsets);	// snippets find the words by their positions
+		}
+
 		calculateTFIDF(tempWordList, fullFileName, numberOfWords);
 
+		if (storePositions_)
+			storePositions(tempWordList, tempPositions, fullFileName);
+
 }
 
 /**
@@ -171,6 +231,7 @@ void Parser::parseFiles(string input)
 {
 	for (int i = 0; i < wordList_.size(); i++)
 		delete wordList_[i];
+	storedPosts_.clear();
 	
 	cout << "Parsing Files in " << input << endl;
 
@@ -240,6 +301,7 @@ void Parser::parseSingleFile(string fullFileName)
 		delete wordList_[i];
 
 	wordList_.clear();
+	storedPosts_.clear();
 
 	parseFile(fullFileName);
 
@@ -259,15 +321,18 @@ void Parser::calculateTFIDF(vector<Word*> tempWordList, string fullFileName, int
 	// and then calculate that term frequency for the document
 	// then calculate the temporary TFIDF and also store values
 	// to aid in recalculation as the parsing continues
+	// a post with an empty body can still have header terms, its frequencies are counted out of one word
+
+	int length = max(numberOfWords, 1);
 
 	for (int i = 0; i < tempWordList.size(); i++)
 	{
-		vector<Word::File*> tempRanking = tempWordList[i]->getRanking();
-		for (int j = 0; j < tempRanking.size(); j++)
+		vector<Word::File*>& tempRanking = tempWordList[i]->getPostings();
+		for (int j = tempRanking.size() - 1; j >= 0; j--)	// the file being read was added last
 		{
 			if (tempRanking[j]->fileName == fullFileName)
 			{
-				double termFrequency = ((double)tempRanking[j]->numberOfAppearances / (double)numberOfWords);
+				double termFrequency = ((double)tempRanking[j]->numberOfAppearances / (double)length);
 				double iDFTemp = ((double)numberOfFiles_ / (double)tempRanking.size());
 				double inverseDocumentFrequency = log10(iDFTemp);
 				double tfidf = termFrequency * inverseDocumentFrequency;
@@ -280,47 +345,62 @@ void Parser::calculateTFIDF(vector<Word*> tempWordList, string fullFileName, int
 }
 
 /**
-	checkStopWord(string) checks to see if the word is a stop word
-	and therefore if we can ignore it
+	checkStopWord(string_view) checks to see if the word is a stop word
+	and therefore if we can ignore it, without copying the word
 	NOTE: this function is PRIVATE
 **/
 
-bool Parser::checkStopWord(string tempWord)
+bool Parser::checkStopWord(string_view tempWord)
 {
+	static const string_view stopWords[] = { "and", "or", "a", "an", "the" };
 
-	int strSize = tempWord.size();
-
-	for (int i = 0; i < strSize; i++)
-		tempWord[i] = tolower(tempWord[i]);
-
-	if (tempWord == "and")
-		return true;
-	else if (tempWord == "or")
-		return true;
-	else if (tempWord == "a")
-		return true;
-	else if (tempWord == "an")
-		return true;
-	else if (tempWord == "the")
-		return true;
-
-	else
-		return false;
+	for (int i = 0; i < 5; i++)
+	{
+		if (stopWords[i].size() != tempWord.size())
+			continue;
+		int j = 0;
+		while (j < tempWord.size() && tolower(tempWord[j]) == stopWords[i][j])
+			j++;
+		if (j == tempWord.size())
+			return true;
+	}
+	return false;
 }
 
 /**
-	doesWordExist returns true if the word is found within the given vector
-	and false if not
-	vector is passed by reference to the head of the vector
+	findWordIndex returns the index of the word within the given vector
+	and -1 if it is not there
 **/
 
-bool Parser::doesWordExist(Word* tempWord, vector<Word*> wordList)
+int Parser::findWordIndex(Word* tempWord, const vector<Word*>& wordList)
 {
 	for (int i = 0; i < wordList.size(); i++)
 		if (wordList[i] == tempWord)
-			return true;
+			return i;
 
-	return false;
+	return -1;
+}
+
+/**
+	storePositions attaches the body offsets collected while reading
+	a file to that file's entry in each word's ranking
+	NOTE: this function is PRIVATE
+**/
+
+void Parser::storePositions(vector<Word*>& tempWordList, vector<vector<int> >& tempPositions, string fullFileName)
+{
+	for (int i = 0; i < tempWordList.size(); i++)
+	{
+		vector<Word::File*>& tempRanking = tempWordList[i]->getPostings();
+		for (int j = tempRanking.size() - 1; j >= 0; j--)	// the file being read was added last
+		{
+			if (tempRanking[j]->fileName == fullFileName)
+			{
+				tempRanking[j]->positions = Word::encodeGaps(tempPositions[i]);
+				break;
+			}
+		}
+	}
 }
 
 /**
@@ -329,12 +409,21 @@ bool Parser::doesWordExist(Word* tempWord, vector<Word*> wordList)
 **/
 
 Word* Parser::getWord(string tempWord, string filePath, int day, string month, int year)
+{
+	return getTerm(stemWord(tempWord), filePath, day, month, year);
+}
+
+/**
+	getTerm is getWord for a term that is already in its indexed form,
+	such as the header terms, which must not go through the stemmer
+	Note: this is PRIVATE
+**/
+
+Word* Parser::getTerm(string tempWord, string filePath, int day, string month, int year)
 {
 	bool found = false;
 	Word* foundWord;
 
-	tempWord = stemWord(tempWord);
-
 	for (int i = 0; i < wordList_.size(); i++)
 	{
 		if (wordList_[i]->getWord() == tempWord)
@@ -347,9 +436,9 @@ Word* Parser::getWord(string tempWord, string filePath, int day, string month, i
 
 	if (found)
 	{
-		vector<Word::File*> tempRanking = foundWord->getRanking();
+		vector<Word::File*>& tempRanking = foundWord->getPostings();
 		bool foundFile = false;
-		for (int i = 0; i < tempRanking.size(); i++)
+		for (int i = tempRanking.size() - 1; i >= 0; i--)	// the file being read was added last
 		{
 			if (tempRanking[i]->fileName == filePath)
 			{
@@ -443,7 +532,8 @@ string Parser::getIndexPath()
 
 /**
 	writeOutputFile writes all of the words and their attributes
-	to the index file on disk
+	to the index file on disk, in sorted order so the file can be
+	bulk loaded
 
 	Refer to oUSE/examples for a sample index file
 	and the corresponding input files
@@ -461,59 +551,111 @@ void Parser::writeOutputFile()
 	}
 
 	myFile << numberOfFiles_;
+	if (storePositions_)
+		myFile << " positions";	// tells the secondary parser to expect a line of offsets per entry
+	myFile << " sorted";	// lets the secondary parser bulk load the words
 	myFile << "\n";
 	myFile << wordList_.size();
 	myFile << "\n";
 
+	sort(wordList_.begin(), wordList_.end(), Word::keyLess);
 	for (int i = 0; i < wordList_.size(); i++)
-	{
-		myFile << wordList_[i]->getWord();
-		myFile << "\n";
+		wordList_[i]->write(myFile, storePositions_, false);
+
+	storedPosts_.writeFields(myFile);
+
+	myFile.close();
+
+	storedPosts_.writeBodies(outputFilePath_ + ".bodies");
+}
 
-		vector<Word::File*> tempRanking = wordList_[i]->getRanking();
-		myFile << tempRanking.size();
-		myFile << "\n";
-		for (int x = 0; x < tempRanking.size(); x++)
+/**
+	fieldTerm gives the index term for a field:token search, or "" for a
+	field that isn't indexed. From and group tokens are only lowercased,
+	subject tokens are stemmed like the body
+**/
+
+string Parser::fieldTerm(string field, string token)
+{
+	for (int i = 0; i < field.size(); i++)
+		field[i] = tolower(field[i]);
+	for (int i = 0; i < token.size(); i++)
+		token[i] = tolower(token[i]);
+
+	if (token == "")
+		return "";
+	if (field == "from")
+		return "from:" + token;
+	if (field == "group" || field == "newsgroups")
+		return "group:" + token;
+	if (field == "subject")
+		return "subject:" + stemWord(token);
+	return "";
+}
+
+/**
+	fieldTerms splits a stored header into its index terms. newsgroups are
+	kept whole so a group is one term, the other headers are split into
+	words the way a user would type them
+**/
+
+vector<string> Parser::fieldTerms(int field, string value)
+{
+	vector<string> terms;
+	string token = "";
+	for (int i = 0; i <= value.size(); i++)
+	{
+		char c = i < value.size() ? value[i] : ' ';
+		bool separator;
+		if (field == DocumentTable::NEWSGROUPS)
+			separator = c == ',' || c == ' ';
+		else
+			separator = !isalnum((unsigned char)c);
+
+		if (!separator)
 		{
-			myFile << tempRanking[x]->fileName;
-			myFile << "\n";
-			myFile << tempRanking[x]->TFIDF;
-			myFile << "\n";
-			myFile << tempRanking[x]->numberOfAppearances;
-			myFile << "\n";
-			myFile << tempRanking[x]->totalWordsInFile;
-			myFile << "\n";
-			myFile << tempRanking[x]->year;
-			myFile << "\n";
-			myFile << tempRanking[x]->strmonth;
-			myFile << "\n";
-			myFile << tempRanking[x]->day;
-			myFile << "\n";
+			token += c;
+			continue;
 		}
+		if (token == "")
+			continue;
+
+		string term = "";
+		if (field == DocumentTable::FROM)
+			term = fieldTerm("from", token);
+		else if (field == DocumentTable::NEWSGROUPS)
+			term = fieldTerm("group", token);
+		else if (field == DocumentTable::SUBJECT && !checkStopWord(token))
+			term = fieldTerm("subject", token);
+		if (term == "subject:re")	// the reply marker would be in most subjects
+			term = "";
+		if (term != "")
+			terms.push_back(term);
+		token = "";
 	}
-
-	myFile.close();
+	return terms;
 }
 
 /**
-	stemWord(string) prepares for and executes the stemming of words
+	stemWord(string_view) prepares for and executes the stemming of words
 	using the included stemming libray based on the Porter Algorithms
-	It also forces the string to lowercase
+	It also forces the string to lowercase. the wide copy the stemmer
+	works on is kept from call to call, one per thread, so only a stem
+	too long for the returned string's own buffer allocates
 **/
 
-string Parser::stemWord(string tempWord)
+string Parser::stemWord(string_view tempWord)
 {
-	int strSize = tempWord.size();
+	static thread_local wstring tempW;
 
-	for (int i = 0; i < strSize; i++)
-		tempWord[i] = tolower(tempWord[i]);
+	tempW.resize(tempWord.size());
+	for (int i = 0; i < tempWord.size(); i++)
+		tempW[i] = (char)tolower(tempWord[i]);
 
-	wstring tempW = string2wstring(tempWord);
     stemming::english_stem<> StemEnglish;
     StemEnglish(tempW);
-	tempWord = wstring2string(tempW);
 
-	return tempWord;
+	return string(tempW.begin(), tempW.end());
 }
 
 /**
@@ -542,6 +684,16 @@ copy(str.begin(),str.end(),wstr.begin());
 return wstr;
 }
 
+/**
+	setStorePositions(bool) turns on recording of word offsets
+	for phrase queries, which makes the index file larger
+**/
+
+void Parser::setStorePositions(bool store)
+{
+	storePositions_ = store;
+}
+
 /**
 	setNumberOfFiles(int) sets the number of files in the directory
 **/
@@ -13,8 +13,10 @@
 #define PARSER_H
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include "Word.h"
+#include "DocumentTable.h"
 //#include <math.h>
 
 using namespace std;
@@ -43,25 +45,35 @@ public:
 
 	void setNumberOfFiles(int );
 
-	bool checkStopWord(string);
+	void setStorePositions(bool);	// opt-in word offsets for phrase queries
 
-	string stemWord(string);
+	bool checkStopWord(string_view);
+
+	string stemWord(string_view);
+
+	string fieldTerm(string, string);	// "from", "group" or "subject" and a token, to the term indexed for it
+
+	vector<string> fieldTerms(int, string);	// every term indexed for a stored header (DocumentTable::Field)
 
 private:
 
 	bool filesAreParsed_;
+	bool storePositions_;
 	string inputFilePath_;
 	string outputFilePath_;
 	int numberOfFiles_;
 	vector<Word*> wordList_;
+	DocumentTable storedPosts_;	// headers of the parsed posts, written after the words
 
 	Word* getWord(string, string, int, string, int);
+	Word* getTerm(string, string, int, string, int);
 
-	bool doesWordExist(Word*, vector<Word*>);
+	int findWordIndex(Word*, const vector<Word*>&);
 
 	void organizeFiles(string);
 	void writeOutputFile();
 	void calculateTFIDF(vector<Word*>, string, int);
+	void storePositions(vector<Word*>&, vector<vector<int> >&, string);
 
 	string wstring2string(wstring);
 	wstring string2wstring(string);
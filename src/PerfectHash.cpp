@@ -0,0 +1,241 @@
+/*File: PerfectHash.cpp
+ *Project: Search Engine
+ *this file contains the functionality of PerfectHash.h
+ */
+
+#include "PerfectHash.h"
+#include <sstream>
+#include <stdlib.h>
+
+using namespace std;
+
+static const unsigned int SEEDS = 16;	//seeds tried before a build gives up
+
+PerfectHash::PerfectHash()
+{
+	keys = 0;
+	buckets = 0;
+	seed = 0;
+}
+
+PerfectHash::~PerfectHash()
+{
+}
+
+//FNV-1a over the letters, then mixed so every bit of the result depends on all of them. the hash is
+//written to the index file, so it can't be std::hash, which may differ from one library to the next
+unsigned long long PerfectHash::hashKey(string_view key, unsigned int seed)
+{
+	unsigned long long hash = 14695981039346656037ULL ^ (seed * 0x9E3779B97F4A7C15ULL);
+	for (int i = 0; i < key.size(); i++)
+	{
+		hash ^= (unsigned char)key[i];
+		hash *= 1099511628211ULL;
+	}
+	return mix(hash);
+}
+
+unsigned long long PerfectHash::mix(unsigned long long hash)
+{
+	hash ^= hash >> 30;
+	hash *= 0xBF58476D1CE4E5B9ULL;
+	hash ^= hash >> 27;
+	hash *= 0x94D049BB133111EBULL;
+	hash ^= hash >> 31;
+	return hash;
+}
+
+//the high half of the hash picks the bucket and its low byte is the fingerprint
+int PerfectHash::bucketOf(unsigned long long hash, unsigned int buckets)
+{
+	return ((hash >> 32) * buckets) >> 32;
+}
+
+//d0 hashes the word again, to a slot of its own that d1 then moves along
+unsigned int PerfectHash::baseOf(unsigned long long hash, unsigned int d0, unsigned int keys)
+{
+	return (unsigned int)(mix(hash + d0 * 0x9E3779B97F4A7C15ULL) >> 32) % keys;
+}
+
+/*
+ *the biggest buckets are placed first, while most slots are free. d0 spreads a bucket's words apart and
+ *d1 moves them along together, so for each d0 the bucket tries every d1 until all its words land on
+ *free slots. two words a bucket can't part otherwise land apart for some d0, and a bucket of one word
+ *just takes the next free slot. the last buckets of several words are the hard part
+ */
+bool PerfectHash::place(vector<unsigned long long>& hashes)
+{
+	vector<int> start(buckets + 1, 0);	//the words of bucket b are order[start[b], start[b + 1])
+	for (int i = 0; i < keys; i++)
+		start[bucketOf(hashes[i], buckets) + 1]++;
+	int largest = 0;
+	for (int b = 0; b < buckets; b++)
+	{
+		largest = max(largest, start[b + 1]);
+		start[b + 1] += start[b];
+	}
+	vector<int> order(keys);
+	vector<int> filled(start.begin(), start.end() - 1);
+	for (int i = 0; i < keys; i++)
+		order[filled[bucketOf(hashes[i], buckets)]++] = i;
+
+	vector<vector<int> > bySize(largest + 1);
+	for (int b = 0; b < buckets; b++)
+		bySize[start[b + 1] - start[b]].push_back(b);
+
+	vector<bool> taken(keys, false);
+	vector<unsigned int> bases(largest);
+	vector<unsigned int> slots(largest);
+	displacements.assign(buckets, 0);
+	fingerprints.assign(keys, 0);
+	unsigned int steps = min((unsigned long long)keys, 0xFFFFFFFFULL / keys);	//d0 * keys + d1 has to fit in 32 bits
+	int nextFree = 0;
+	for (int size = largest; size > 0; size--)
+	{
+		for (int j = 0; j < bySize[size].size(); j++)
+		{
+			int b = bySize[size][j];
+			int* members = &order[start[b]];
+			bool placed = false;
+			if (size == 1)
+			{
+				while (taken[nextFree])
+					nextFree++;
+				slots[0] = nextFree;
+				displacements[b] = (nextFree + keys - baseOf(hashes[members[0]], 0, keys)) % keys;
+				placed = true;
+			}
+			for (unsigned int d0 = 0; d0 < steps && !placed; d0++)
+			{
+				bool apart = true;
+				for (int k = 0; k < size; k++)
+				{
+					bases[k] = baseOf(hashes[members[k]], d0, keys);
+					for (int l = 0; l < k; l++)
+						apart = apart && bases[l] != bases[k];
+				}
+				for (unsigned int d1 = 0; d1 < keys && apart && !placed; d1++)
+				{
+					placed = true;
+					for (int k = 0; k < size && placed; k++)
+					{
+						slots[k] = bases[k] + d1 < keys ? bases[k] + d1 : bases[k] + d1 - keys;
+						placed = !taken[slots[k]];
+					}
+					if (placed)
+						displacements[b] = d0 * keys + d1;
+				}
+			}
+			if (!placed)
+				return false;
+			for (int k = 0; k < size; k++)
+			{
+				taken[slots[k]] = true;
+				fingerprints[slots[k]] = (unsigned char)hashes[members[k]];
+			}
+		}
+	}
+	return true;
+}
+
+bool PerfectHash::build(vector<Word*>& words)
+{
+	clear();
+	keys = words.size();
+	if (keys == 0)
+		return true;
+
+	//each seed that fails adds buckets, which only small sets of words ever need
+	vector<unsigned long long> hashes(keys);
+	for (seed = 0; seed < SEEDS; seed++)
+	{
+		buckets = min(keys, (keys + BUCKET_SIZE - 1) / BUCKET_SIZE + seed * (keys / SEEDS + 1));
+		for (int i = 0; i < keys; i++)
+			hashes[i] = hashKey(words[i]->getKey(), seed);
+		if (place(hashes))
+			return true;
+	}
+	clear();
+	return false;
+}
+
+int PerfectHash::find(string_view key)
+{
+	if (keys == 0)
+		return -1;
+	unsigned long long hash = hashKey(key, seed);
+	unsigned int displacement = displacements[bucketOf(hash, buckets)];
+	unsigned int slot = baseOf(hash, displacement / keys, keys) + displacement % keys;
+	if (slot >= keys)
+		slot -= keys;
+	return fingerprints[slot] == (unsigned char)hash ? slot : -1;
+}
+
+int PerfectHash::size()
+{
+	return keys;
+}
+
+int PerfectHash::bytes()
+{
+	return buckets * sizeof(unsigned int) + keys;
+}
+
+/*
+ *the section is a line "perfecthash <keys> <buckets> <seed>", then a line of the displacements and a line
+ *of the fingerprints, as numbers. index files written by the other structures end before it, a reader
+ *that finds no section builds the hash from the words
+ */
+void PerfectHash::write(ostream& out)
+{
+	out << "perfecthash " << keys << " " << buckets << " " << seed << "\n";
+	for (int b = 0; b < buckets; b++)
+		out << (b > 0 ? " " : "") << displacements[b];
+	out << "\n";
+	for (int i = 0; i < keys; i++)
+		out << (i > 0 ? " " : "") << (int)fingerprints[i];
+	out << "\n";
+}
+
+bool PerfectHash::read(istream& in, string sectionLine)
+{
+	clear();
+	if (sectionLine.find("perfecthash ") != 0)
+		return false;
+	stringstream header(sectionLine.substr(12));
+	if (!(header >> keys >> buckets >> seed) || (keys == 0) != (buckets == 0))
+	{
+		clear();
+		return false;
+	}
+	string line;
+	getline(in, line);
+	stringstream displacementLine(line);
+	displacements.resize(buckets);
+	for (int b = 0; b < buckets; b++)
+		displacementLine >> displacements[b];
+	getline(in, line);
+	stringstream fingerprintLine(line);
+	fingerprints.resize(keys);
+	int fingerprint = 0;
+	for (int i = 0; i < keys; i++)
+	{
+		fingerprintLine >> fingerprint;
+		fingerprints[i] = (unsigned char)fingerprint;
+	}
+	if (!displacementLine || !fingerprintLine)
+	{
+		clear();
+		return false;
+	}
+	return true;
+}
+
+void PerfectHash::clear()
+{
+	vector<unsigned int>().swap(displacements);
+	vector<unsigned char>().swap(fingerprints);
+	keys = 0;
+	buckets = 0;
+	seed = 0;
+}
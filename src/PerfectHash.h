@@ -0,0 +1,54 @@
+/*File: PerfectHash.h
+ *Project: Search Engine
+ *this file implements a minimal perfect hash of an index's words, which gives each of n words its own
+ *slot from 0 to n - 1 with one hash of the word and no probing. it is built by hash and displace: the
+ *words are split into buckets of about five, and each bucket gets a displacement that moves all of its
+ *words to free slots. a byte of every word's hash is kept in its slot, so most words that aren't in the
+ *index are turned away without reading a word. a PerfectHashMap writes it as the last section of its
+ *index file, so the index is loaded without building it again. the section is text like the rest of the
+ *file and is parsed, not mapped: loading an index parses every word and posting into the structure anyway,
+ *and the hash is read in one pass over about 14 bits a word, a small part of that load
+ */
+
+#ifndef PERFECTHASH_H
+#define PERFECTHASH_H
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Word.h"
+
+using namespace std;
+
+class PerfectHash
+{
+public:
+	PerfectHash();
+	~PerfectHash();
+
+	bool build(vector<Word*>& words);	//false when no hash was found, which takes two words with the same text
+	int find(string_view key);	//the key's slot, -1 when its fingerprint shows it is none of the words. a word that isn't one of them can still get a slot
+	int size();
+	int bytes();	//the displacements and fingerprints, about 14 bits a word
+	void write(ostream& out);	//the perfecthash section of an index file
+	bool read(istream& in, string sectionLine);	//the section started by sectionLine, false when it isn't one or is cut short
+	void clear();
+
+	static const int BUCKET_SIZE = 5;	//words per bucket on average, fewer means more displacements to store and faster builds
+
+private:
+	static unsigned long long hashKey(string_view key, unsigned int seed);
+	static unsigned long long mix(unsigned long long hash);
+	static int bucketOf(unsigned long long hash, unsigned int buckets);
+	static unsigned int baseOf(unsigned long long hash, unsigned int d0, unsigned int keys);
+	bool place(vector<unsigned long long>& hashes);	//finds displacements for the words hashed with one seed, false when a bucket fits nowhere
+
+	unsigned int keys;
+	unsigned int buckets;
+	unsigned int seed;
+	vector<unsigned int> displacements;	//by bucket, d0 * keys + d1 puts a word d1 slots after the slot d0 hashes it to
+	vector<unsigned char> fingerprints;	//by slot
+};
+
+#endif
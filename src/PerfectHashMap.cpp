@@ -0,0 +1,218 @@
+/*File: PerfectHashMap.cpp
+ *Project: Search Engine
+ *this file contains the functionality of PerfectHashMap.h
+ */
+
+#include "PerfectHashMap.h"
+
+using namespace std;
+
+bool keyBefore(Word* word, string_view key) {return word->getKey() < key;}
+
+PerfectHashMap::PerfectHashMap()
+{
+	sorted = true;
+	sealed = false;
+}
+
+PerfectHashMap::~PerfectHashMap()
+{
+	releaseWords();
+}
+
+//appended, a word that sorts after the last one keeps the array sorted, as when an index file is read
+void PerfectHashMap::insert(Word* newWord)
+{
+	if (refuseChange())
+	{
+		destroyWord(newWord);	//the structure owns the words handed to it, even ones it turns away
+		return;
+	}
+	invalidateDictionary();
+	if (!words.empty() && !Word::keyLess(words.back(), newWord))
+		sorted = false;
+	words.push_back(newWord);
+}
+
+//a stable sort keeps the word inserted first ahead of a later one with the same text, which it takes the files of
+void PerfectHashMap::sortWords()
+{
+	if (sorted)
+		return;
+	stable_sort(words.begin(), words.end(), Word::keyLess);
+	int kept = 0;
+	for (int i = 0; i < words.size(); i++)
+	{
+		if (kept > 0 && words[kept - 1]->getKey() == words[i]->getKey())
+			mergeWord(words[kept - 1], words[i]);
+		else
+			words[kept++] = words[i];
+	}
+	words.resize(kept);
+	sorted = true;
+}
+
+bool PerfectHashMap::refuseChange()
+{
+	if (sealed)
+		cerr << "the index is read only once its words are hashed" << endl;
+	return sealed;
+}
+
+//like the dictionary, the hash is built on first use. getWords builds it too, so FileIndex::finalize does
+void PerfectHashMap::seal()
+{
+	if (sealed)
+		return;
+	sortWords();
+	if (!hash.build(words) || !placeWords())
+		slots.clear();	//found no hash, lookups fall back on a binary search
+	sealed = true;
+}
+
+vector<Word*>::iterator PerfectHashMap::lowerBound(string_view key)
+{
+	return lower_bound(words.begin(), words.end(), key, keyBefore);
+}
+
+bool PerfectHashMap::placeWords()
+{
+	slots.assign(words.size(), NULL);
+	if (hash.size() != words.size())
+		return false;
+	for (int i = 0; i < words.size(); i++)
+	{
+		int slot = hash.find(words[i]->getKey());
+		if (slot < 0 || slots[slot] != NULL)
+			return false;
+		slots[slot] = words[i];
+	}
+	return true;
+}
+
+void PerfectHashMap::readPerfectHash(istream& in, string sectionLine)
+{
+	if (sealed)
+		return;
+	sortWords();
+	if (hash.read(in, sectionLine) && placeWords())
+		sealed = true;
+	else
+		seal();	//written by another structure, or for other words
+}
+
+Word* PerfectHashMap::find(string_view lookup)
+{
+	seal();
+	if (slots.empty())
+	{
+		vector<Word*>::iterator it = lowerBound(lookup);
+		return it != words.end() && (*it)->getKey() == lookup ? *it : NULL;
+	}
+	int slot = hash.find(lookup);
+	if (slot < 0 || slots[slot]->getKey() != lookup)
+		return NULL;
+	return slots[slot];
+}
+
+void PerfectHashMap::findPrefix(string_view prefix, vector<Word*>& found, int limit)
+{
+	sortWords();
+	vector<Word*>::iterator it = lowerBound(prefix);
+	for (; it != words.end() && found.size() < limit; it++)
+	{
+		if ((*it)->getKey().compare(0, prefix.size(), prefix) != 0)
+			return;
+		found.push_back(*it);
+	}
+}
+
+void PerfectHashMap::del(Word* deleteValue)
+{
+	if (refuseChange())
+		return;
+	invalidateDictionary();
+	sortWords();
+	vector<Word*>::iterator it = lowerBound(deleteValue->getKey());
+	if (it == words.end() || (*it)->getKey() != deleteValue->getKey())
+	{
+		cout << "element not found" << endl;
+		return;
+	}
+	Word* word = *it;
+	words.erase(it);
+	destroyWord(word);
+}
+
+int PerfectHashMap::nonodes()
+{
+	sortWords();
+	return words.size();
+}
+
+int PerfectHashMap::bytes()
+{
+	return hash.bytes() + (slots.capacity() + words.capacity()) * sizeof(Word*);
+}
+
+void PerfectHashMap::clear()
+{
+	getDocuments().clear();
+	releaseWords();
+	vector<Word*>().swap(words);
+	vector<Word*>().swap(slots);
+	hash.clear();
+	sorted = true;
+	sealed = false;
+}
+
+void PerfectHashMap::bulkLoad(vector<Word*>& newWords)
+{
+	if (refuseChange())
+	{
+		for (int i = 0; i < newWords.size(); i++)
+			destroyWord(newWords[i]);
+		return;
+	}
+	if (!words.empty())
+	{
+		FileIndex::bulkLoad(newWords);
+		return;
+	}
+	invalidateDictionary();
+	words = newWords;
+}
+
+void PerfectHashMap::getWords(vector<Word*>& found)
+{
+	seal();
+	found.insert(found.end(), words.begin(), words.end());
+}
+
+void PerfectHashMap::printValues(int)
+{
+	sortWords();
+	for (int j = 0; j < words.size(); j++)
+		cout << words[j]->getKey() << endl;
+}
+
+void PerfectHashMap::writeToFile(string fileName)
+{
+	ofstream outFile;
+	outFile.open(fileName.c_str());
+	if (!outFile.is_open())
+	{
+		cerr << "file not found" << endl;
+	}
+	else
+	{
+		writeHeader(outFile);
+		seal();
+		for (int i = 0; i < words.size(); i++)
+			words[i]->write(outFile, storesPositions(), storesImpacts(), &getDocuments());
+		getDocuments().writeFields(outFile);
+		hash.write(outFile);	//last, readers of the other structures stop after the fields
+		outFile.close();
+		getDocuments().writeBodies(fileName + ".bodies");
+	}
+}
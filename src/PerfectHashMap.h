@@ -0,0 +1,59 @@
+/*File: PerfectHashMap.h
+ *Project: Search Engine
+ *this file implements a read only index of words for indexes that are built once and then searched.
+ *the words are kept in a sorted array, for prefix searches and writing, and are looked up through a
+ *minimal perfect hash: one hash of the word picks its slot, the slot's fingerprint turns away most
+ *other words, and one comparison with the word in the slot settles it. the hash is written at the end
+ *of the index file, so loading an index this structure wrote doesn't have to build it. once the hash is
+ *built or read the index is read only, words can't be inserted or deleted until it is cleared
+ */
+
+#ifndef PERFECTHASHMAP_H
+#define PERFECTHASHMAP_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fstream>
+#include "Word.h"
+#include "FileIndex.h"
+#include "PerfectHash.h"
+
+using namespace std;
+
+class PerfectHashMap : public FileIndex
+{
+public:
+	PerfectHashMap();
+	~PerfectHashMap();
+
+	//the words are inserted before the hash is built, by the first lookup or getWords. a word inserted
+	//twice takes the new word's files, see FileIndex::insert. after that inserts and deletes are refused
+	void insert(Word* newWord);
+	void printValues(int);
+	void del(Word* deleteValue);
+	Word* find(string_view lookup);
+	void findPrefix(string_view prefix, vector<Word*>& words, int limit);	//a binary search of the sorted words, no dictionary is needed
+	int nonodes();
+	void clear();
+	void writeToFile(string fileName);
+	void getWords(vector<Word*>& words);	//in sorted order, the hash is built first so the dictionary leaves nothing for queries to build
+	void bulkLoad(vector<Word*>& words);	//takes the sorted words as they are
+	void readPerfectHash(istream& in, string sectionLine);	//uses the hash in the section if it was written for these words, otherwise builds one
+	int bytes();	//the hash, the slots and the sorted array
+
+private:
+	void sortWords();	//sorts words inserted out of order and merges any inserted twice
+	void seal();	//sorts the words and builds the hash, the first time it is called
+	bool refuseChange();	//true, after saying so, once the index is read only
+	bool placeWords();	//fills slots from the hash, false when the hash wasn't built for exactly these words
+	vector<Word*>::iterator lowerBound(string_view key);	//the first of the sorted words not less than key
+
+	vector<Word*> words;	//sorted, unless sorted is false
+	vector<Word*> slots;	//the words by their slot in the hash
+	PerfectHash hash;
+	bool sorted;
+	bool sealed;	//the hash is built, or read, and slots filled from it. no word is inserted or deleted after
+};
+
+#endif
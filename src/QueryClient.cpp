@@ -0,0 +1,93 @@
+/*File: QueryClient.cpp
+ *Project: Search Engine
+ *this file contains the functionality of QueryClient.h
+ */
+
+#include "QueryClient.h"
+#include <sstream>
+#include <stdlib.h>
+
+using namespace std;
+
+QueryClient::QueryClient()
+{
+	socket_ = NULL;
+}
+
+QueryClient::~QueryClient()
+{
+	delete socket_;
+}
+
+bool QueryClient::connectTo(string address)
+{
+	delete socket_;
+	address_ = address;
+	socket_ = LineSocket::connectTo(address);
+	return socket_ != NULL;
+}
+
+bool QueryClient::isConnected()
+{
+	return socket_ != NULL;
+}
+
+string QueryClient::getAddress()
+{
+	return address_;
+}
+
+vector<QueryClient::Hit> QueryClient::query(string query)
+{
+	vector<Hit> hits;
+	if (socket_ == NULL || !socket_->write(query + "\n") || !readResults(hits))
+		hits.clear();
+	return hits;
+}
+
+vector<vector<QueryClient::Hit> > QueryClient::queryAll(const vector<string>& queries)
+{
+	vector<vector<Hit> > answers(queries.size());
+	if (socket_ == NULL)
+		return answers;
+
+	string requests;
+	for (int i = 0; i < queries.size(); i++)
+		requests += queries[i] + "\n";
+	if (!socket_->write(requests))
+		return answers;
+
+	for (int i = 0; i < queries.size(); i++)
+		if (!readResults(answers[i]))
+			break;
+	return answers;
+}
+
+bool QueryClient::readResults(vector<Hit>& hits)
+{
+	string line;
+	if (!socket_->readLine(line))
+		return false;
+	int count = atoi(line.c_str());
+	hits.resize(count);
+	for (int i = 0; i < count; i++)
+	{
+		if (!socket_->readLine(line))
+			return false;
+		stringstream fields(line);
+		string field;
+		getline(fields, field, '\t');
+		hits[i].score = atof(field.c_str());
+		getline(fields, field, '\t');
+		hits[i].year = atoi(field.c_str());
+		getline(fields, hits[i].strmonth, '\t');
+		getline(fields, field, '\t');
+		hits[i].day = atoi(field.c_str());
+		getline(fields, hits[i].fileName, '\t');
+		getline(fields, hits[i].from, '\t');
+		getline(fields, hits[i].subject, '\t');
+		getline(fields, hits[i].newsgroups, '\t');
+		getline(fields, hits[i].messageId);
+	}
+	return true;
+}
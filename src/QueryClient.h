@@ -0,0 +1,43 @@
+/*File: QueryClient.h
+ *Project: Search Engine
+ *this file implements the client side of the query daemon's protocol, see QueryDaemon.h
+ */
+
+#ifndef QUERYCLIENT_H
+#define QUERYCLIENT_H
+
+#include <string>
+#include <vector>
+#include "LineSocket.h"
+
+using namespace std;
+
+class QueryClient
+{
+public:
+	struct Hit {
+		string fileName;
+		double score;
+		int year, day;
+		string strmonth;
+		string from, subject, newsgroups, messageId;
+		string snippet;     //only filled in by the local search, the daemon doesn't send snippets
+	};
+
+	QueryClient();
+	~QueryClient();
+
+	bool connectTo(string address);
+	bool isConnected();
+	string getAddress();
+	vector<Hit> query(string query);
+	vector<vector<Hit> > queryAll(const vector<string>& queries);  //sends every query before reading the first answer
+
+private:
+	bool readResults(vector<Hit>& hits);
+
+	LineSocket* socket_;
+	string address_;
+};
+
+#endif
@@ -0,0 +1,134 @@
+/*File: QueryDaemon.cpp
+ *Project: Search Engine
+ *this file contains the functionality of QueryDaemon.h
+ */
+
+#include "QueryDaemon.h"
+#include <sstream>
+
+using namespace std;
+
+QueryDaemon::QueryDaemon(QueryServer* server, string address, int limit)
+{
+	server_ = server;
+	address_ = address;
+	limit_ = limit;
+	listener_ = -1;
+	active_ = 0;
+}
+
+QueryDaemon::~QueryDaemon()
+{
+	stop();
+}
+
+bool QueryDaemon::start()
+{
+	listener_ = LineSocket::listenOn(address_);
+	return listener_ >= 0;
+}
+
+void QueryDaemon::run()
+{
+	while (true)
+	{
+		LineSocket* socket = LineSocket::acceptFrom(listener_);
+		if (socket == NULL)
+			break;
+
+		Connection* connection = new Connection;
+		connection->socket = socket;
+		connection->finished = false;
+
+		lock_guard<mutex> lock(connectionsLock_);
+		connections_.push_back(connection);
+		active_++;
+		thread(&QueryDaemon::serveConnection, this, connection).detach();	// the thread ends its connection itself
+	}
+
+	unique_lock<mutex> lock(connectionsLock_);	// the listener is gone, hang up on the clients still connected
+	for (list<Connection*>::iterator it = connections_.begin(); it != connections_.end(); it++)
+		(*it)->socket->disconnect();
+	while (active_ > 0)
+		allEnded_.wait(lock);
+}
+
+void QueryDaemon::stop()
+{
+	if (listener_ >= 0)
+	{
+		LineSocket::closeListener(listener_, address_);
+		listener_ = -1;
+	}
+}
+
+/**
+	serveConnection reads queries and hands them straight to the query server,
+	a second thread writes the answers back as they finish, oldest first
+**/
+void QueryDaemon::serveConnection(Connection* connection)
+{
+	thread writer(&QueryDaemon::writeResults, this, connection);
+
+	string query;
+	while (connection->socket->readLine(query))
+	{
+		if (query.size() > 0 && query[query.size() - 1] == '\r')
+			query.erase(query.size() - 1);
+		{
+			lock_guard<mutex> lock(connection->lock);
+			connection->inFlight.push(server_->submit(query, limit_));
+		}
+		connection->ready.notify_one();
+	}
+
+	{
+		lock_guard<mutex> lock(connection->lock);
+		connection->finished = true;
+	}
+	connection->ready.notify_one();
+	writer.join();
+
+	lock_guard<mutex> lock(connectionsLock_);
+	connections_.remove(connection);
+	delete connection->socket;
+	delete connection;
+	active_--;
+	allEnded_.notify_all();	// still locked, so run can't return, and the daemon be deleted, before the daemon is let go of
+}
+
+void QueryDaemon::writeResults(Connection* connection)
+{
+	while (true)
+	{
+		future<QueryServer::Results> pending;
+		{
+			unique_lock<mutex> lock(connection->lock);
+			while (connection->inFlight.empty() && !connection->finished)
+				connection->ready.wait(lock);
+			if (connection->inFlight.empty())
+				break;
+			pending = move(connection->inFlight.front());
+			connection->inFlight.pop();
+		}
+		QueryServer::Results results = pending.get();
+		connection->socket->write(formatResults(results));
+	}
+	connection->socket->shutdownWrites();
+}
+
+string QueryDaemon::formatResults(QueryServer::Results& results)
+{
+	DocumentTable& documents = server_->getIndex()->getDocuments();
+	stringstream out;
+	out << results.size() << "\n";
+	for (int i = 0; i < results.size(); i++)
+	{
+		DocumentTable::Document& post = documents.get(results[i].docId);
+		out << results[i].score << "\t" << post.year << "\t" << post.strmonth << "\t" << post.day << "\t" << post.fileName;
+		for (int field = 0; field < DocumentTable::NUMBER_OF_FIELDS; field++)
+			out << "\t" << documents.getField(results[i].docId, field);
+		out << "\n";
+	}
+	return out.str();
+}
@@ -0,0 +1,62 @@
+/*File: QueryDaemon.h
+ *Project: Search Engine
+ *this file implements a long running server that keeps one index loaded and answers
+ *queries from local clients over a unix domain socket or a TCP port on 127.0.0.1
+ *
+ *the protocol is one query per line. for every query, in the order they were sent, the
+ *daemon answers with a line holding the number of results followed by one line per result:
+ *	score <tab> year <tab> month <tab> day <tab> file name <tab> from <tab> subject <tab> newsgroups <tab> message id
+ *a client may send any number of queries before reading the answers, they are searched
+ *concurrently by the query server's threads
+ */
+
+#ifndef QUERYDAEMON_H
+#define QUERYDAEMON_H
+
+#include <string>
+#include <list>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include "QueryServer.h"
+#include "LineSocket.h"
+
+using namespace std;
+
+class QueryDaemon
+{
+public:
+	QueryDaemon(QueryServer* server, string address, int limit = 100);  //limit is the most results sent for a query
+	~QueryDaemon();
+
+	bool start();           //false when the address can't be listened on
+	void run();             //accepts clients until stop is called
+	void stop();            //only closes the listener, so it is safe to call from a signal handler
+
+private:
+	struct Connection {
+		LineSocket* socket;
+		queue<future<QueryServer::Results> > inFlight;     //answers not written yet, in the order the queries came in
+		mutex lock;
+		condition_variable ready;
+		bool finished;
+	};
+
+	void serveConnection(Connection* connection);
+	void writeResults(Connection* connection);
+	string formatResults(QueryServer::Results& results);
+
+	QueryServer* server_;
+	string address_;
+	int limit_;
+	int listener_;
+
+	list<Connection*> connections_;	//the clients connected now, a connection's thread removes it when the client leaves
+	int active_;	//connection threads that haven't ended yet, they are detached so none is left to join
+	mutex connectionsLock_;
+	condition_variable allEnded_;
+};
+
+#endif
@@ -1,12 +1,36 @@
 //Query Processor written by Andrew Socha
 
 #include "QueryProcessor.h"
+#include "Intersection.h"
+#include <unordered_map>
+#include <stdlib.h>
+#include <ctype.h>
 
-bool sortFunction(Word::File* i, Word::File* j) {return *i>*j;} //used to sort files_ by TFIDF (greatest to least)
+bool sortFunction(const QueryProcessor::Result& i, const QueryProcessor::Result& j) {return i.score > j.score;} //used to sort results_ by score (greatest to least)
+bool fewerPostings(Word* i, Word* j) {return i->getTotalNumberDocuments() < j->getTotalNumberDocuments();}
+
+//swaps each whole word of the query that is typed for correction, a word inside a "quoted phrase" included
+string replaceWord(string query, string typed, string correction){
+    stringstream words(query);
+    string word, replaced;
+    while (words >> word){
+        int start = word[0] == '"' ? 1 : 0;
+        int end = word.size() > start && word[word.size() - 1] == '"' ? word.size() - 1 : word.size();
+        if (word.compare(start, end - start, typed) == 0) word = word.substr(0, start) + correction + word.substr(end);
+        if (replaced != "") replaced += " ";
+        replaced += word;
+    }
+    return replaced;
+}
 
 QueryProcessor::QueryProcessor(FileIndex* index, /*const*/ Parser& parser) {
 	FI = index;
 	P = parser;
+	ranked_ = 0;
+	collectHighlights_ = true;
+	maxExpansions_ = 64;
+	scorer_ = new BM25Scorer;
+	ownsScorer_ = true;
 }
 /*
 QueryProcessor::QueryProcessor(const QueryProcessor& orig) {
@@ -17,11 +41,26 @@ const QueryProcessor& QueryProcessor::operator=(const QueryProcessor& rhs){
 }
 
 QueryProcessor::~QueryProcessor() {
+    clearTemporaryWords();
+    if (ownsScorer_) delete scorer_;
 }
 
 void QueryProcessor::Query(string query){
 
-	files_.clear();
+	results_.clear();
+	ranked_ = 0;
+	query_ = query;
+	highlights_.clear();
+	collectHighlights_ = true;
+	typedWords_.clear();
+	clearTemporaryWords();
+	if (!scorer_->isPreparedFor(FI)) scorer_->prepare(FI);   //posts or words were added since the last query
+
+	evaluate(query);
+}
+
+//runs the operators of a query, leaving the matching files in results_ in post id order
+void QueryProcessor::evaluate(string query){
 
 	stringstream queryStream(query);
     string first, next; //first is used to obtain AND and OR search terms, as well as the first word to be queried
@@ -29,143 +68,257 @@ void QueryProcessor::Query(string query){
     
     //all return statements mean we have reached the end of the query
     
-    queryStream >> first;
+    readTerm(queryStream, first);
     if (first == "AND"){ //AND          note: only AND needs to worry about stop words as ORing or NOTing with a stop word will not change the file set
-        queryStream >> first;
+        readTerm(queryStream, first);
         while (P.checkStopWord(first)){
-            queryStream >> first;
+            readTerm(queryStream, first);
             if (first == "NOT" || first == "DATEGT" || first == "DATELT") return;
             if (queryStream.eof()){
                 if (P.checkStopWord(first)) return;
                 else{
-                    first = P.stemWord(first);
-                    firstWord(FI->find(first));
+                    firstWord(lookup(first));
                     return;
                 }
             }
         }
-        first = P.stemWord(first);
-        firstWord(FI->find(first));
+        vector<Word*> terms;    //collected so words with bitmaps can be ANDed together
+        terms.push_back(lookup(first));
         
-        queryStream >> next;
+        bool finished = false;
+        readTerm(queryStream, next);
         while (next != "NOT" && next != "DATEGT" && next != "DATELT"){
-            next = P.stemWord(next);
-            if (!P.checkStopWord(next)) And(FI->find(next));
-            if (queryStream.eof()) return;
-            queryStream >> next;
+            if (!P.checkStopWord(next)) terms.push_back(lookup(next));
+            if (queryStream.eof()){
+                finished = true;
+                break;
+            }
+            readTerm(queryStream, next);
         }
+        AndAll(terms);
+        if (finished) return;
     }
     else if (first == "OR"){ //OR
-        queryStream >> first;
-        first = P.stemWord(first);
-        firstWord(FI->find(first));
+        readTerm(queryStream, first);
+        firstWord(lookup(first));
         
-        queryStream >> next;
+        readTerm(queryStream, next);
         while (next != "NOT" && next != "DATEGT" && next != "DATELT"){
-            next = P.stemWord(next);
-            Or(FI->find(next));
+            Or(lookup(next));
             if (queryStream.eof()) return;
-            queryStream >> next;
+            readTerm(queryStream, next);
         }
     }
     else{ //single word search
-        first = P.stemWord(first);
-        if (!P.checkStopWord(first)) firstWord(FI->find(first));
+        if (!P.checkStopWord(first)) firstWord(lookup(first));
         else return;
-        queryStream >> next;
+        readTerm(queryStream, next);
     }
     
     if (next == "NOT"){ //NOT
-        queryStream >> next;
+        collectHighlights_ = false;
+        vector<Word*> terms;
+        bool finished = false;
+        readTerm(queryStream, next);
         while (next != "DATEGT" && next != "DATELT"){
-            next = P.stemWord(next);
-            Not(FI->find(next));
-            if (queryStream.eof()) return;
-            queryStream >> next;
+            terms.push_back(lookup(next));
+            if (queryStream.eof()){
+                finished = true;
+                break;
+            }
+            readTerm(queryStream, next);
         }
+        NotAll(terms);
+        if (finished) return;
     }
     
     if (next == "DATEGT"){ //Date Greater Than
-        queryStream >> next;
+        readTerm(queryStream, next);
         DateGreater(next);
-        queryStream >> next;
+        readTerm(queryStream, next);
     }
     
     if (next == "DATELT"){ //Date Lesser Than
-        queryStream >> next;
+        readTerm(queryStream, next);
         DateLesser(next);
-        queryStream >> next;
+        readTerm(queryStream, next);
     }
     
     if (next == "DATEGT"){ //repeats Date Greater Than incase user does Less Than followed by Greater Than
-        queryStream >> next;
+        readTerm(queryStream, next);
         DateGreater(next);
     }
 }
 
+//fills results_ with the files containing the given word
 void QueryProcessor::firstWord(Word* word){
     if (word == 0) return;
-    vector<Word::File*> index = word->getRanking();
-    for(int i = 0; i < index.size(); i++){  //initializes files_ with the files containing the given word
-        files_.push_back(index[i]);
-    }
-    sort(files_.begin(), files_.end(), sortFunction);
+    scorePostings(word, results_);
 }
 
-//takes each file in files_ and compares it to each file with the given word, removing the file if it does not contain that word
+//keeps only the files in results_ that also contain the given word, adding up their scores
+//both lists are in post id order, so this is a single merge
 void QueryProcessor::And(Word* word){
     if (word == 0){
-        files_.clear();
+        results_.clear();
         return;
     }
-    vector<Word::File*> index = word->getRanking();
-    for (int j = 0; j < files_.size(); j++){
-        bool wasFound = false;
-        for (int i = 0; i < index.size(); i++){
-            if (files_[j]->fileName == index[i]->fileName){
-                wasFound = true;
-                files_[j]->TFIDF += index[i]->TFIDF;      //when a file contains more than one word from the search, adds their TFIDFs
-
-                i = index.size();      //breaks out of the inner for loop
-            }
-        }
-        if (!wasFound){
-            files_.erase(files_.begin() + j);
-            j--;
+    Bitmap* bitmap = bitmapOf(word);
+    if (bitmap != 0){    //a common word is checked against the results rather than merged with them
+        double weight = scorer_->weight(word);
+        const vector<int>& docIds = word->getDocIds();     //a rank counts from 1 into these
+        const vector<int>& frequencies = word->getFrequencies();
+        int kept = 0;
+        for (int j = 0; j < results_.size(); j++){
+            int rank = bitmap->rank(results_[j].docId);
+            if (rank == 0 || docIds[rank - 1] != results_[j].docId) continue;
+            results_[kept] = results_[j];
+            results_[kept].score += scorer_->score(weight, frequencies[rank - 1], results_[j].docId);
+            kept++;
         }
+        results_.resize(kept);
+        return;
+    }
+    vector<Result> index;
+    scorePostings(word, index);
+    if (results_.empty() || index.empty()){
+        results_.clear();
+        return;
+    }
+
+    //the ids are intersected on their own so the vector kernels can run, then the scores are picked up
+    vector<int> left(results_.size());
+    vector<int> right(index.size());
+    for (int i = 0; i < results_.size(); i++) left[i] = results_[i].docId;
+    for (int i = 0; i < index.size(); i++) right[i] = index[i].docId;
+    vector<int> both(min(left.size(), right.size()));
+    int kept = Intersection::intersect(&left[0], left.size(), &right[0], right.size(), &both[0]);
+
+    int i = 0;
+    int j = 0;
+    for (int k = 0; k < kept; k++){
+        while (results_[j].docId != both[k]) j++;
+        while (index[i].docId != both[k]) i++;
+        results_[k].docId = both[k];
+        results_[k].score = results_[j].score + index[i].score;      //when a file contains more than one word from the search, adds their scores
     }
-    sort(files_.begin(), files_.end(), sortFunction);
+    results_.resize(kept);
 }
 
-//takes each file with the given word and checks if that file is already in files_. if it is not, inserts it
+//adds the files containing the given word to results_, adding up the scores of files found in both
 void QueryProcessor::Or(Word* word){
     if (word == 0) return;
-    vector<Word::File*> index = word->getRanking();
-    for(int i = 0; i < index.size(); i++){
-        int j = 0;
-        while (j < files_.size() && index[i]->fileName != files_[j]->fileName) j++;         //checks all files from files_ from the file from index
-        if (j < files_.size()){ //if the file is found...
-            files_[j]->TFIDF += index[i]->TFIDF;      //when a file contains more than one word from the search, adds their TFIDFs
-        }
-        else{ //else, inserts the file in files_
-            files_.push_back(index[i]);
+    vector<Result> index;
+    scorePostings(word, index);
+    vector<Result> merged;
+    merged.reserve(results_.size() + index.size());
+    int i = 0;
+    int j = 0;
+    while (i < index.size() || j < results_.size()){
+        if (j == results_.size() || (i < index.size() && index[i].docId < results_[j].docId)) merged.push_back(index[i++]);
+        else if (i == index.size() || results_[j].docId < index[i].docId) merged.push_back(results_[j++]);
+        else{
+            merged.push_back(results_[j++]);
+            merged.back().score += index[i++].score;
         }
     }
-    sort(files_.begin(), files_.end(), sortFunction);
+    results_.swap(merged);
 }
 
-//gets all files with the given word and compares each file to the files in files_, removing all files from files_ that contain the word
+//removes all files from results_ that contain the given word
 void QueryProcessor::Not(Word* word){
     if (word == 0) return;
-    vector<Word::File*> index = word->getRanking();
-    for(int i = 0; i < index.size(); i++){
-        for (int j = 0; j < files_.size(); j++){
-            if (files_[j]->fileName == index[i]->fileName){
-                files_.erase(files_.begin() + j);
-                j--;
-            }
+    Bitmap* bitmap = bitmapOf(word);
+    if (bitmap != 0){
+        removeFound(*bitmap);
+        return;
+    }
+    vector<Result> index;
+    scorePostings(word, index);
+    int kept = 0;
+    int i = 0;
+    for (int j = 0; j < results_.size(); j++){
+        while (i < index.size() && index[i].docId < results_[j].docId) i++;
+        if (i == index.size() || index[i].docId != results_[j].docId) results_[kept++] = results_[j];
+    }
+    results_.resize(kept);
+}
+
+//ANDs the words of a query together. words with bitmaps are ANDed as bitmaps when the query has
+//nothing else, otherwise the other words are merged shortest first and the bitmaps filter the result
+void QueryProcessor::AndAll(vector<Word*>& terms){
+    vector<Word*> lists;
+    vector<Word*> bitmaps;
+    for (int i = 0; i < terms.size(); i++){
+        if (terms[i] == 0){
+            results_.clear();
+            return;
         }
+        if (bitmapOf(terms[i]) != 0) bitmaps.push_back(terms[i]);
+        else lists.push_back(terms[i]);
     }
+
+    if (lists.empty()){
+        Bitmap both = *bitmapOf(bitmaps[0]);
+        for (int i = 1; i < bitmaps.size(); i++) both = Bitmap::And(both, *bitmapOf(bitmaps[i]));
+        vector<int> docIds;
+        both.toVector(docIds);
+        results_.resize(docIds.size());
+        for (int j = 0; j < docIds.size(); j++){
+            results_[j].docId = docIds[j];
+            results_[j].score = 0;
+        }
+        for (int i = 0; i < bitmaps.size(); i++){    //every result is in every bitmap, so only the scores are looked up
+            double weight = scorer_->weight(bitmaps[i]);
+            Bitmap* bitmap = bitmapOf(bitmaps[i]);
+            const vector<int>& frequencies = bitmaps[i]->getFrequencies();
+            for (int j = 0; j < results_.size(); j++)
+                results_[j].score += scorer_->score(weight, frequencies[bitmap->rank(results_[j].docId) - 1], results_[j].docId);
+        }
+        return;
+    }
+
+    sort(lists.begin(), lists.end(), fewerPostings);
+    firstWord(lists[0]);
+    for (int i = 1; i < lists.size(); i++) And(lists[i]);
+    for (int i = 0; i < bitmaps.size(); i++) And(bitmaps[i]);
+}
+
+//removes the files containing any of the words, the bitmaps of common words are ORed and removed in one pass
+void QueryProcessor::NotAll(vector<Word*>& terms){
+    Bitmap excluded;
+    bool anyBitmap = false;
+    for (int i = 0; i < terms.size(); i++){
+        if (terms[i] == 0) continue;
+        Bitmap* bitmap = bitmapOf(terms[i]);
+        if (bitmap == 0) Not(terms[i]);
+        else if (!anyBitmap){
+            excluded = *bitmap;
+            anyBitmap = true;
+        }
+        else excluded = Bitmap::Or(excluded, *bitmap);
+    }
+    if (anyBitmap) removeFound(excluded);
+}
+
+//the results' post ids are made a bitmap and the excluded ones ANDNOTed out of it container by container,
+//results_ is in post id order so the ids left are merged back into it
+void QueryProcessor::removeFound(Bitmap& excluded){
+    vector<int> ids(results_.size());
+    for (int j = 0; j < results_.size(); j++) ids[j] = results_[j].docId;
+    Bitmap found;
+    found.build(ids);
+    Bitmap::AndNot(found, excluded).toVector(ids);
+    int kept = 0;
+    for (int j = 0; j < results_.size() && kept < ids.size(); j++)
+        if (results_[j].docId == ids[kept]) results_[kept++] = results_[j];
+    results_.resize(kept);
+}
+
+//the word's bitmap if it has one the operators can use, quantized impacts take precedence so their scores are used
+Bitmap* QueryProcessor::bitmapOf(Word* word){
+    if (word->getImpacts() != 0 && FI->getImpactScorer() == scorer_->getName()) return 0;
+    return word->getBitmap();
 }
 
 //removes files dated less than the given date
@@ -178,15 +331,12 @@ void QueryProcessor::DateGreater(string date){  //date in the form mm/dd/yyyy
     dateStream.ignore();
     dateStream >> year;
     
-    for (int j = 0; j < files_.size(); j++){    //loops through files_, removing all files with a date lesser than the given date
-        if (files_[j]->year < year) files_.erase(files_.begin() + j);
-        else if (files_[j]->year == year && files_[j]->month < month) files_.erase(files_.begin() + j);
-        else if (files_[j]->year == year && files_[j]->month == month && files_[j]->day <= day) files_.erase(files_.begin() + j);
-        
-        //the following 2 lines decrement j only if a File has been deleted (this is to prevent the loop from skipping a file)
-        else j++;
-        j--;
-    }
+    const vector<int>& dates = FI->getDocuments().getDates();
+    int bound = DocumentTable::packDate(year, month, day);
+    int kept = 0;
+    for (int j = 0; j < results_.size(); j++)    //loops through results_, keeping the files dated after the given date
+        if (dates[results_[j].docId] > bound) results_[kept++] = results_[j];
+    results_.resize(kept);
 }
 
 //removes files dated greater than the given date
@@ -199,17 +349,343 @@ void QueryProcessor::DateLesser(string date){   //date in the form mm/dd/yyyy
     dateStream.ignore();
     dateStream >> year;
     
-    for (int j = 0; j < files_.size(); j++){    //loops through files_, removing all files with a date greater than the given date
-        if (files_[j]->year > year) files_.erase(files_.begin() + j);
-        else if (files_[j]->year == year && files_[j]->month > month) files_.erase(files_.begin() + j);
-        else if (files_[j]->year == year && files_[j]->month == month && files_[j]->day >= day) files_.erase(files_.begin() + j);
-        
-        //the following 2 lines decrement j only if a File has been deleted (this is to prevent the loop from skipping a file)
-        else j++;
-        j--;
+    const vector<int>& dates = FI->getDocuments().getDates();
+    int bound = DocumentTable::packDate(year, month, day);
+    int kept = 0;
+    for (int j = 0; j < results_.size(); j++)    //loops through results_, keeping the files dated before the given date
+        if (dates[results_[j].docId] < bound) results_[kept++] = results_[j];
+    results_.resize(kept);
+}
+
+//scores every file of the word and puts them in post id order so the operators can merge them
+void QueryProcessor::scorePostings(Word* word, vector<Result>& postings){
+    ImpactList* impacts = word->getImpacts();
+    if (impacts != 0 && FI->getImpactScorer() == scorer_->getName()){    //quantized when the index was built, in the word's post id order
+        const vector<int>& docIds = word->getDocIds();
+        vector<double> scores;
+        impacts->decode(scores);
+        postings.resize(docIds.size());
+        for (int i = 0; i < docIds.size(); i++){
+            postings[i].docId = docIds[i];
+            postings[i].score = scores[i];
+        }
+        return;
+    }
+
+    double weight = scorer_->weight(word);
+    const vector<int>& docIds = word->getDocIds();      //post id order, index words were frozen with the dictionary
+    const vector<int>& frequencies = word->getFrequencies();
+    postings.resize(docIds.size());
+    for (int i = 0; i < docIds.size(); i++){
+        postings[i].docId = docIds[i];
+        postings[i].score = scorer_->score(weight, frequencies[i], docIds[i]);
+    }
+}
+
+//reads the next search term, keeping a "quoted phrase" together as one term
+void QueryProcessor::readTerm(stringstream& queryStream, string& term){
+    queryStream >> term;
+    if (term.size() == 0 || term[0] != '"') return;
+    while ((term.size() == 1 || term[term.size() - 1] != '"') && !queryStream.eof()){
+        string rest;
+        queryStream >> rest;
+        term += " " + rest;
+    }
+}
+
+//finds the postings for a search term, matching it as a phrase if it is quoted
+//field:term looks in one header, group:comp.graphics or group:comp.* narrows to newsgroups
+//term~1 and term~2 also match words one or two typos away
+Word* QueryProcessor::lookup(const string& term){
+    if (term.size() > 0 && term[0] == '"') return phrase(term);
+    if (term.size() > 1 && term[term.size() - 1] == '*') return expand(term.substr(0, term.size() - 1));
+    if (term.size() > 2 && term[term.size() - 2] == '~' && (term[term.size() - 1] == '1' || term[term.size() - 1] == '2'))
+        return fuzzy(term.substr(0, term.size() - 2), term[term.size() - 1] - '0');
+    int colon = term.find(':');
+    if (colon != string::npos && colon > 0){     //from:, group: and subject: search the terms indexed from the headers
+        string fieldTerm = P.fieldTerm(term.substr(0, colon), term.substr(colon + 1));
+        if (fieldTerm != "") return FI->find(fieldTerm);
+    }
+    string stem = P.stemWord(term);
+    Word* word = FI->find(stem);
+    highlight(word);
+    checkSpelling(term, stem, word);
+    return word;
+}
+
+void QueryProcessor::highlight(Word* word){
+    if (word != 0 && collectHighlights_) highlights_.push_back(word);
+}
+
+//builds a temporary word holding the files of every word starting with the prefix
+//the prefix is only lowercased, stemming it could cut it shorter than the user typed.
+//fr* or s* leave out the from: and subject: terms, a header prefix such as group:comp.* only matches header terms
+Word* QueryProcessor::expand(string prefix){
+    for (int i = 0; i < prefix.size(); i++) prefix[i] = tolower(prefix[i]);
+
+    bool field = Word::isFieldTerm(prefix);
+    vector<Word*> words;
+    for (int limit = maxExpansions_; ; ){      //asks again for as many more words as were left out
+        vector<Word*> found;
+        FI->findPrefix(prefix, found, limit);
+        words.clear();
+        for (int i = 0; i < found.size() && words.size() < maxExpansions_; i++)
+            if (Word::isFieldTerm(found[i]->getKey()) == field) words.push_back(found[i]);
+        if (found.size() < limit || words.size() >= maxExpansions_) break;
+        limit += found.size() - words.size();
+    }
+    return merge(prefix + "*", words);
+}
+
+//builds a temporary word holding the files of every word within edits typos of the term, the term
+//is matched in its indexed form: stemmed, or as a header term for field:term
+Word* QueryProcessor::fuzzy(string term, int edits){
+    string key = P.stemWord(term);
+    int colon = term.find(':');
+    if (colon != string::npos && colon > 0){
+        string fieldTerm = P.fieldTerm(term.substr(0, colon), term.substr(colon + 1));
+        if (fieldTerm != "") key = fieldTerm;
+    }
+
+    vector<Word*> words;
+    FI->getDictionary()->findWithin(key, edits, words, maxExpansions_);
+    stringstream name;
+    name << key << "~" << edits;
+    return merge(name.str(), words);
+}
+
+//one word holding the postings of all the given words, used by the terms that expand to several words
+Word* QueryProcessor::merge(string name, vector<Word*>& words){
+    for (int k = 0; k < words.size(); k++) highlight(words[k]);
+    if (words.size() == 0) return 0;
+    if (words.size() == 1) return words[0];
+
+    Word* result = new Word(name);
+    temporaryWords_.push_back(result);
+    unordered_map<int, Word::File*> merged;      //one pass over every expanded posting, adding up appearances per file
+    for (int k = 0; k < words.size(); k++){
+        const vector<int>& docIds = words[k]->getDocIds();
+        const vector<int>& frequencies = words[k]->getFrequencies();
+        const vector<double>& scores = words[k]->getScores();
+        for (int i = 0; i < docIds.size(); i++){
+            unordered_map<int, Word::File*>::iterator it = merged.find(docIds[i]);
+            if (it == merged.end()) merged[docIds[i]] = result->addPosting(docIds[i], scores[i], frequencies[i]);
+            else{
+                it->second->TFIDF += scores[i];
+                it->second->numberOfAppearances += frequencies[i];
+            }
+        }
+    }
+    result->freeze(false);      //built by this query alone, then only read like the index's words
+    return result;
+}
+
+void QueryProcessor::setMaxExpansions(int limit){
+    maxExpansions_ = limit;
+}
+
+//builds a temporary word holding every file that contains the phrase, the number of matches
+//in a file is scored like the appearances of a single word. without stored positions a phrase falls back to requiring all of its words
+Word* QueryProcessor::phrase(string quoted){
+    string text = quoted.substr(1);
+    if (text.size() > 0 && text[text.size() - 1] == '"') text.erase(text.size() - 1);
+
+    stringstream phraseStream(text);
+    vector<Word*> words;
+    vector<int> offsets;    //position of each word within the phrase, stop words still take up a slot
+    string term;
+    for (int offset = 0; phraseStream >> term; offset++){
+        if (P.checkStopWord(term)) continue;
+        string stem = P.stemWord(term);
+        Word* word = FI->find(stem);
+        checkSpelling(term, stem, word);
+        if (word == 0) return 0;        //a missing word means no file holds the phrase
+        highlight(word);
+        words.push_back(word);
+        offsets.push_back(offset);
+    }
+    if (words.size() == 0) return 0;
+    if (words.size() == 1) return words[0];
+
+    vector<unordered_map<int, int> > byDoc(words.size());      //post id to the posting's number in each word's arrays
+    for (int k = 1; k < words.size(); k++){
+        const vector<int>& docIds = words[k]->getDocIds();
+        for (int i = 0; i < docIds.size(); i++) byDoc[k][docIds[i]] = i;
+    }
+
+    Word* result = new Word(text);
+    temporaryWords_.push_back(result);
+    const vector<int>& docIds = words[0]->getDocIds();
+    vector<vector<int> > positions(words.size());
+    for (int i = 0; i < docIds.size(); i++){
+        double tfidf = words[0]->getScores()[i];
+        bool inAll = true;
+        for (int k = 1; k < words.size() && inAll; k++){
+            unordered_map<int, int>::iterator it = byDoc[k].find(docIds[i]);
+            if (it == byDoc[k].end()) inAll = false;
+            else{
+                tfidf += words[k]->getScores()[it->second];
+                if (FI->storesPositions()) positions[k] = words[k]->getPositions(it->second);
+            }
+        }
+        if (!inAll) continue;
+
+        int matches = 1;
+        if (FI->storesPositions()){
+            positions[0] = words[0]->getPositions(i);
+            matches = countPhrase(positions, offsets);
+        }
+        if (matches > 0) result->addPosting(docIds[i], tfidf, matches);
+    }
+    result->freeze(false);
+    return result;
+}
+
+//counts the places where every word appears at its offset from the phrase start
+//each list is only walked forward, so this is linear in the total number of positions
+int QueryProcessor::countPhrase(vector<vector<int> >& positions, vector<int>& offsets){
+    vector<int> at(positions.size(), 0);
+    int matches = 0;
+    while (at[0] < positions[0].size()){
+        int start = positions[0][at[0]] - offsets[0];
+        bool matched = true;
+        for (int k = 1; k < positions.size() && matched; k++){
+            while (at[k] < positions[k].size() && positions[k][at[k]] - offsets[k] < start) at[k]++;
+            if (at[k] == positions[k].size()) return matches;
+            if (positions[k][at[k]] - offsets[k] > start){     //no match here, skip the first word ahead to the next possible start
+                matched = false;
+                int next = positions[k][at[k]] - offsets[k];
+                while (at[0] < positions[0].size() && positions[0][at[0]] - offsets[0] < next) at[0]++;
+            }
+        }
+        if (matched){
+            matches++;
+            at[0]++;
+        }
     }
+    return matches;
+}
+
+void QueryProcessor::clearTemporaryWords(){
+    for (int i = 0; i < temporaryWords_.size(); i++) delete temporaryWords_[i];
+    temporaryWords_.clear();
+}
+
+vector<QueryProcessor::Result> QueryProcessor::getResults(){
+    rankThrough(results_.size());
+    return results_;
+}
+
+int QueryProcessor::getNumberOfResults(){
+    return results_.size();
+}
+
+//results are only put in score order when a page needs them, each deeper page partially sorts
+//what is left below the part already ranked instead of sorting every match up front
+void QueryProcessor::rankThrough(int count){
+    if (count > results_.size()) count = results_.size();
+    if (count <= ranked_) return;
+    partial_sort(results_.begin() + ranked_, results_.begin() + count, results_.end(), sortFunction);
+    ranked_ = count;
+}
+
+QueryProcessor::Page QueryProcessor::getPage(int offset, int pageSize){
+    Page page;
+    if (offset < 0) offset = 0;
+    rankThrough(offset + pageSize);
+    for (int i = offset; i < offset + pageSize && i < results_.size(); i++) page.results.push_back(results_[i]);
+
+    if (offset + pageSize < results_.size()){   //the token holds the query too, so any query processor can continue it
+        stringstream token;
+        token << offset + pageSize << ":" << query_;
+        page.next = token.str();
+    }
+    return page;
+}
+
+//a token that isn't "<offset>:<query>" with an offset inside the query's results gets an empty page
+QueryProcessor::Page QueryProcessor::getPage(string token, int pageSize){
+    int colon = token.find(':');
+    if (colon == string::npos || colon == 0 || !isdigit((unsigned char)token[0])) return Page();
+    char* end;
+    long offset = strtol(token.c_str(), &end, 10);
+    if (end != token.c_str() + colon) return Page();    //more than digits before the separator
+    string query = token.substr(colon + 1);
+    if (query != query_) Query(query);
+    if (offset >= results_.size()) return Page();
+    return getPage((int)offset, pageSize);
+}
+
+//the hits are the query words' positions, the body comes from the index rather than the post's file.
+//an index without positions has no snippets, finding the words would mean stemming the body again
+string QueryProcessor::getSnippet(int docId, int length){
+    DocumentTable& documents = FI->getDocuments();
+    if (!FI->storesPositions() || !documents.hasBody(docId)) return "";
+
+    vector<int> hits;
+    for (int i = 0; i < highlights_.size(); i++){
+        int posting = findPosting(highlights_[i], docId);
+        if (posting < 0) continue;
+        vector<int> positions = highlights_[i]->getPositions(posting);
+        hits.insert(hits.end(), positions.begin(), positions.end());
+    }
+    return documents.snippet(docId, hits, length);
+}
+
+void QueryProcessor::checkSpelling(const string& typed, const string& stem, Word* word){
+    if (!collectHighlights_) return;    //a typo in a NOT term can only let more results through
+    TypedWord typedWord;
+    typedWord.text = typed;
+    typedWord.stem = stem;
+    typedWord.documents = word == 0 ? 0 : word->getTotalNumberDocuments();
+    typedWords_.push_back(typedWord);
+}
+
+//the query again with every word that is missing, or rare when few posts matched, swapped for a more
+//common word a typo or two away. each suggestion after the first takes the next correction of each word
+vector<string> QueryProcessor::getSuggestions(int count){
+    vector<string> suggestions;
+    if (results_.size() >= SPARSE_RESULTS) return suggestions;
+
+    Suggester* suggester = FI->getSuggester();
+    vector<vector<Suggester::Suggestion> > corrections(typedWords_.size());
+    int most = 0;
+    for (int i = 0; i < typedWords_.size(); i++){
+        corrections[i] = suggester->suggest(typedWords_[i].stem, typedWords_[i].documents * RARER, count);
+        most = max(most, (int)corrections[i].size());
+    }
+
+    for (int k = 0; k < most; k++){
+        string query = query_;
+        for (int i = 0; i < typedWords_.size(); i++){
+            if (corrections[i].empty()) continue;
+            query = replaceWord(query, typedWords_[i].text, corrections[i][min(k, (int)corrections[i].size() - 1)].term);
+        }
+        if (find(suggestions.begin(), suggestions.end(), query) == suggestions.end()) suggestions.push_back(query);
+    }
+    return suggestions;
+}
+
+int QueryProcessor::findPosting(Word* word, int docId){
+    const vector<int>& docIds = word->getDocIds();     //in post id order, the same order as the word's other arrays
+    Bitmap* bitmap = word->getBitmap();
+    if (bitmap != 0){
+        int rank = bitmap->rank(docId);     //counts from 1
+        if (rank > 0 && docIds[rank - 1] == docId) return rank - 1;
+        return -1;
+    }
+    vector<int>::const_iterator it = lower_bound(docIds.begin(), docIds.end(), docId);
+    if (it == docIds.end() || *it != docId) return -1;
+    return it - docIds.begin();
+}
+
+//switches the ranking function, a scorer that isn't owned can be shared with other query processors
+void QueryProcessor::setScorer(Scorer* scorer, bool owned){
+    if (ownsScorer_) delete scorer_;
+    scorer_ = scorer;
+    ownsScorer_ = owned;
 }
 
-vector<Word::File*> QueryProcessor::getFiles(){
-    return files_;
+Scorer* QueryProcessor::getScorer(){
+    return scorer_;
 }
\ No newline at end of file
@@ -7,6 +7,7 @@
 #include <vector>
 #include "FileIndex.h"
 #include "Parser.h"
+#include "Scorer.h"
 
 using namespace std;
 
@@ -15,20 +16,75 @@ public:
     QueryProcessor(FileIndex*, /*const*/ Parser&);
     virtual ~QueryProcessor();
 
+    struct Result {
+        int docId;          //look the post up in the index's document table
+        double score;
+    };
+
+    //one page of ranked results, next is the token for the page after it and is empty on the last page
+    struct Page {
+        vector<Result> results;
+        string next;
+    };
+
 	void Query(string query);
-    vector<Word::File*> getFiles();
+    vector<Result> getResults();        //matching files, best score first
+    Page getPage(int offset, int pageSize);     //ranks only as far as the page reaches
+    Page getPage(string token, int pageSize);   //continues from a token, running its query again if another query ran since, empty for a malformed token
+    int getNumberOfResults();
+    string getSnippet(int docId, int length = 20);  //words of the post around the last query's words, which are in [brackets]
+    vector<string> getSuggestions(int count = 3);   //the last query with likely corrections for its words, best first, empty if it found enough
+    void setScorer(Scorer* scorer, bool owned = true);     //BM25 unless told otherwise
+    Scorer* getScorer();
+    void setMaxExpansions(int limit);     //most words a single prefix* or fuzzy~ term may expand to
 private:
    // QueryProcessor(const QueryProcessor& orig);
     const QueryProcessor& operator=(const QueryProcessor& rhs);
     
+    void evaluate(string query);
     void firstWord(Word* word);
     void And(Word* word);
     void Or(Word* word);
     void Not(Word* word);
+    void AndAll(vector<Word*>& terms);
+    void NotAll(vector<Word*>& terms);
+    void removeFound(Bitmap& excluded);
+    Bitmap* bitmapOf(Word* word);
     void DateGreater(string date);
     void DateLesser(string date);
     
-    vector<Word::File*> files_;
+    void readTerm(stringstream& queryStream, string& term);
+    Word* lookup(const string& term);
+    Word* phrase(string quoted);
+    Word* expand(string prefix);
+    Word* fuzzy(string term, int edits);
+    Word* merge(string name, vector<Word*>& words);
+    int countPhrase(vector<vector<int> >& positions, vector<int>& offsets);
+    void clearTemporaryWords();
+    void scorePostings(Word* word, vector<Result>& postings);
+    void rankThrough(int count);
+    void highlight(Word* word);
+    int findPosting(Word* word, int docId);
+    void checkSpelling(const string& typed, const string& stem, Word* word);
+    
+    struct TypedWord {
+        string text;        //as it was written in the query
+        string stem;
+        int documents;      //posts the word is found in, 0 when it isn't in the index
+    };
+    static const int SPARSE_RESULTS = 5;    //fewer results than this and rare words are offered corrections too
+    static const int RARER = 10;            //a word that is in the index is only corrected to one this many times as common
+    
+    vector<Result> results_;
+    int ranked_;                        //results_ is in score order up to here, the rest are all lower and unsorted
+    string query_;
+    vector<Word*> highlights_;          //index words the query searched the bodies for, not the NOT terms
+    bool collectHighlights_;
+    vector<TypedWord> typedWords_;      //plain words of the last query outside its NOT part, the ones that can be corrected
+    vector<Word*> temporaryWords_;     //temporary words built for "quoted phrase", prefix* and fuzzy~ terms, freed on the next query
+    int maxExpansions_;
+    Scorer* scorer_;
+    bool ownsScorer_;
 
 	FileIndex* FI;
 	Parser P;
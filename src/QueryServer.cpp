@@ -0,0 +1,112 @@
+/*File: QueryServer.cpp
+ *Project: Search Engine
+ *this file contains the functionality of QueryServer.h
+ */
+
+#include "QueryServer.h"
+
+using namespace std;
+
+QueryServer::QueryServer(FileIndex* index, int numberOfThreads)
+{
+	index_ = index;
+	stopping_ = false;
+
+	if (numberOfThreads <= 0)
+		numberOfThreads = thread::hardware_concurrency();
+	if (numberOfThreads <= 0)
+		numberOfThreads = 1;
+
+	index_->finalize();
+	scorer_ = new BM25Scorer;
+	scorer_->prepare(index_);
+
+	for (int i = 0; i < numberOfThreads; i++)
+	{
+		QueryProcessor* processor = new QueryProcessor(index_, parser_);
+		processor->setScorer(scorer_, false);
+		processors_.push_back(processor);
+	}
+	for (int i = 0; i < numberOfThreads; i++)
+		threads_.push_back(thread(&QueryServer::work, this, i));
+}
+
+QueryServer::~QueryServer()
+{
+	{
+		lock_guard<mutex> lock(jobsLock_);
+		stopping_ = true;
+	}
+	jobReady_.notify_all();
+	for (int i = 0; i < threads_.size(); i++)
+		threads_[i].join();
+
+	for (int i = 0; i < processors_.size(); i++)
+		delete processors_[i];
+	delete scorer_;
+}
+
+future<QueryServer::Results> QueryServer::submit(string query, int limit)
+{
+	Job* job = new Job;
+	job->query = query;
+	job->limit = limit;
+	future<Results> results = job->results.get_future();
+	{
+		lock_guard<mutex> lock(jobsLock_);
+		jobs_.push(job);
+	}
+	jobReady_.notify_one();
+	return results;
+}
+
+/**
+	runAll submits every query before waiting on any of them
+	so all the threads stay busy, the results come back in query order
+**/
+vector<QueryServer::Results> QueryServer::runAll(const vector<string>& queries, int limit)
+{
+	vector<future<Results> > pending;
+	for (int i = 0; i < queries.size(); i++)
+		pending.push_back(submit(queries[i], limit));
+
+	vector<Results> results(queries.size());
+	for (int i = 0; i < pending.size(); i++)
+		results[i] = pending[i].get();
+	return results;
+}
+
+int QueryServer::getNumberOfThreads()
+{
+	return threads_.size();
+}
+
+FileIndex* QueryServer::getIndex()
+{
+	return index_;
+}
+
+void QueryServer::work(int worker)
+{
+	QueryProcessor* processor = processors_[worker];
+	while (true)
+	{
+		Job* job;
+		{
+			unique_lock<mutex> lock(jobsLock_);
+			while (jobs_.empty() && !stopping_)
+				jobReady_.wait(lock);
+			if (jobs_.empty())
+				return;
+			job = jobs_.front();
+			jobs_.pop();
+		}
+
+		processor->Query(job->query);
+		if (job->limit > 0)
+			job->results.set_value(processor->getPage(0, job->limit).results);	// only the top of the results is sorted
+		else
+			job->results.set_value(processor->getResults());
+		delete job;
+	}
+}
@@ -0,0 +1,60 @@
+/*File: QueryServer.h
+ *Project: Search Engine
+ *this file implements a pool of threads answering queries against one shared index
+ *the index is finalized before the threads start and never changed while they run, so the
+ *words, postings and score tables are only read and the threads share them without locks.
+ *each thread has its own query processor for the state of the query it is working on
+ */
+
+#ifndef QUERYSERVER_H
+#define QUERYSERVER_H
+
+#include <string>
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include "FileIndex.h"
+#include "Parser.h"
+#include "QueryProcessor.h"
+#include "Scorer.h"
+
+using namespace std;
+
+class QueryServer
+{
+public:
+	typedef vector<QueryProcessor::Result> Results;
+
+	QueryServer(FileIndex* index, int numberOfThreads);    //0 threads uses one per core
+	~QueryServer();                                         //finishes the queries already submitted
+
+	future<Results> submit(string query, int limit = 0);    //best limit results, all of them when limit is 0
+	vector<Results> runAll(const vector<string>& queries, int limit = 0);
+	int getNumberOfThreads();
+	FileIndex* getIndex();
+
+private:
+	struct Job {
+		string query;
+		int limit;
+		promise<Results> results;
+	};
+
+	void work(int worker);
+
+	FileIndex* index_;
+	Parser parser_;
+	Scorer* scorer_;                        //prepared once, shared by every query processor
+	vector<QueryProcessor*> processors_;
+	vector<thread> threads_;
+
+	queue<Job*> jobs_;                      //only the hand off of queries is locked, not the search
+	mutex jobsLock_;
+	condition_variable jobReady_;
+	bool stopping_;
+};
+
+#endif
@@ -0,0 +1,95 @@
+/*File: Scorer.cpp
+ *Project: Search Engine
+ *this file contains the functionality of Scorer.h
+ */
+
+#include "Scorer.h"
+#include <math.h>
+
+using namespace std;
+
+Scorer::Scorer()
+{
+	saturation = 0;
+	numberOfDocuments = 0;
+	preparedDocuments = -1;
+	preparedTerms = -1;
+}
+void Scorer::prepare(FileIndex* index)
+{
+	DocumentTable& documents = index->getDocuments();
+	TermDictionary* dictionary = index->getDictionary();
+	numberOfDocuments = max(index->getCorpusSize(), documents.size());
+
+	double averageLength = documents.averageLength();
+	const vector<int>& lengths = documents.getLengths();
+	docNorms.resize(lengths.size());
+	for(int i = 0; i < lengths.size(); i++)
+	{
+		docNorms[i] = documentNorm(lengths[i], averageLength);
+	}
+
+	termWeights.resize(dictionary->size());
+	for(int i = 0; i < dictionary->size(); i++)
+	{
+		termWeights[i] = termWeight(dictionary->at(i)->getTotalNumberDocuments(), numberOfDocuments);
+	}
+
+	preparedDocuments = documents.size();
+	preparedTerms = dictionary->size();
+}
+bool Scorer::isPreparedFor(FileIndex* index)
+{
+	return preparedDocuments == index->getDocuments().size() && preparedTerms == index->getDictionary()->size();
+}
+double Scorer::weight(Word* word)
+{
+	int id = word->getId();
+	if(id >= 0 && id < termWeights.size())
+	{
+		return termWeights[id];
+	}
+	return termWeight(word->getTotalNumberDocuments(), numberOfDocuments);   //phrases and prefix expansions aren't in the dictionary
+}
+
+BM25Scorer::BM25Scorer(double k1, double b)
+{
+	k1_ = k1;
+	b_ = b;
+	saturation = 1;
+}
+double BM25Scorer::documentNorm(int length, double averageLength)
+{
+	if(averageLength <= 0)
+	{
+		return k1_;
+	}
+	return k1_ * (1 - b_ + b_ * length / averageLength);
+}
+double BM25Scorer::termWeight(int documentFrequency, int numberOfDocuments)
+{
+	double idf = log(1 + (numberOfDocuments - documentFrequency + 0.5) / (documentFrequency + 0.5));
+	return (k1_ + 1) * idf;
+}
+
+TfIdfScorer::TfIdfScorer()
+{
+	saturation = 0;
+}
+//the plain length, as the parser's TFIDF divides by it, the average length only matters to BM25
+double TfIdfScorer::documentNorm(int length, double)
+{
+	if(length < 1)
+	{
+		return 1;	//a post with header terms and an empty body, counted as one word like the parser does
+	}
+	return length;
+}
+double TfIdfScorer::termWeight(int documentFrequency, int numberOfDocuments)
+{
+	if(documentFrequency == 0)
+	{
+		return 0;
+	}
+	return log10((double)numberOfDocuments / (double)documentFrequency);
+}
@@ -0,0 +1,75 @@
+/*File: Scorer.h
+ *Project: Search Engine
+ *this file implements the ranking functions used by the query processor
+ *every per post and per word value that needs a logarithm or a division by the average
+ *is worked out once in prepare, so scoring a posting is a lookup and a few multiply-adds
+ */
+
+#ifndef SCORER_H
+#define SCORER_H
+
+#include <string>
+#include <vector>
+#include "Word.h"
+#include "FileIndex.h"
+
+using namespace std;
+
+class Scorer
+{
+public:
+	Scorer();
+	virtual ~Scorer() {}
+
+	virtual string getName() = 0;
+	void prepare(FileIndex* index);         //fills the tables for the posts and words currently in the index
+	bool isPreparedFor(FileIndex* index);   //false once posts or words were added after prepare
+	double weight(Word* word);              //per word factor, looked up once for each word of a query
+	double score(double weight, int frequency, int docId)    //frequency is the number of appearances in the post
+	{
+		return weight * frequency / (frequency * saturation + docNorms[docId]);
+	}
+
+protected:
+	virtual double documentNorm(int length, double averageLength) = 0;
+	virtual double termWeight(int documentFrequency, int numberOfDocuments) = 0;
+
+	double saturation;                      //how much a high frequency is damped, 0 for plain term frequency
+
+private:
+	vector<float> docNorms;                 //indexed by post id
+	vector<float> termWeights;              //indexed by the word's position in the index's sorted dictionary
+	int numberOfDocuments;
+	int preparedDocuments;
+	int preparedTerms;
+};
+
+//Okapi BM25, the default ranking
+class BM25Scorer: public Scorer
+{
+public:
+	BM25Scorer(double k1 = 1.2, double b = 0.75);
+	string getName() { return "BM25"; }
+
+protected:
+	double documentNorm(int length, double averageLength);
+	double termWeight(int documentFrequency, int numberOfDocuments);
+
+private:
+	double k1_;
+	double b_;
+};
+
+//the original frequency / length * log10(posts / posts containing the word) ranking
+class TfIdfScorer: public Scorer
+{
+public:
+	TfIdfScorer();
+	string getName() { return "TFIDF"; }
+
+protected:
+	double documentNorm(int length, double averageLength);
+	double termWeight(int documentFrequency, int numberOfDocuments);
+};
+
+#endif
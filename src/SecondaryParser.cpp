@@ -2,6 +2,8 @@
 
 using namespace std;
 
+bool impactBefore(const pair<int, int>& i, const pair<int, int>& j) {return i.first < j.first;}
+
 SecondaryParser::SecondaryParser()
 {
 
@@ -27,8 +29,22 @@ void SecondaryParser::parseFile(string fileName)
 		string str = "";
 		getline(infile, str);
 		index->setCorpusSize(atoi(str.c_str())); // retrieves the number of posts 
+		bool hasPositions = str.find("positions") != string::npos;	// opt-in flag written after the post count
+		index->setStoresPositions(hasPositions);
+		bool sorted = str.find("sorted") != string::npos;	// words in increasing order, so they can be bulk loaded
+		string impactScorer = "";	// "impacts <scorer> <bits>" when the postings hold impacts in place of their scores
+		int impactBits = 0;
+		stringstream flags(str);
+		string flag;
+		while(flags >> flag)
+		{
+			if(flag == "impacts")
+				flags >> impactScorer >> impactBits;
+		}
 		getline(infile, str);   //retrieves the second line of the file with number of words
 		int loopCounterFromFile = atoi(str.c_str());
+		vector<Word*> words;
+		words.reserve(loopCounterFromFile);
 		for(int i = 0; i < loopCounterFromFile; i++)
 		{
 			/*getline(infile, str);           //number of words contained in the file index
@@ -38,16 +54,23 @@ void SecondaryParser::parseFile(string fileName)
 			int docsize = atoi(str.c_str());
 			index->setCorpusSize(docsize);*/
 			getline(infile, str);           //retrieves the first word in the file
-			Word* temp = new Word(str);
+			Word* temp = index->newWord(str);	// bump allocated, along with its files, in the index's arena
 			getline(infile, str);           //# of files containing the word
 			int loopCounterFromFile2 = atoi(str.c_str());//converts # of files to an int
+			float step = 0;
+			vector<pair<int, int> > levels;	// post id and impact of each posting
+			if(impactScorer != "")
+			{
+				getline(infile, str);	// the word's step, the score of one impact level
+				step = atof(str.c_str());
+			}
 			for(int i = 0; i < loopCounterFromFile2; i++)
 			{
 				getline(infile, str); //filename;
 
 				string str2;
-				getline(infile, str2);//TFIDF ranking double
-				double d1 = atof(str2.c_str());
+				getline(infile, str2);//TFIDF ranking double, or the impact level
+				double d1 = impactScorer != "" ? atoi(str2.c_str()) * step : atof(str2.c_str());
 
 				string str3;	
 				getline(infile, str3);  //number of appearances in that file int 
@@ -69,10 +92,46 @@ void SecondaryParser::parseFile(string fileName)
 				getline(infile, daytemp);
 				int day = atoi(daytemp.c_str());
 
-				temp->addFile(str, d1, i1, i2, year, monthtemp, day);
+				int docId = index->getDocuments().add(str, i2, year, temp->calculateMonth(monthtemp), monthtemp, day);
+				Word::File* file = temp->addPosting(docId, d1, i1);	// the name, length and date are kept once per post, in the document table
+				if(impactScorer != "")
+					levels.push_back(make_pair(file->docId, atoi(str2.c_str())));
+
+				if(hasPositions)
+				{
+					string positionstemp;
+					getline(infile, positionstemp);	// gaps between the word offsets in the post
+					file->positions = Word::positionsFromText(positionstemp);
+				}
+			}
+			if(impactScorer != "")
+			{
+				stable_sort(levels.begin(), levels.end(), impactBefore);	// the word's postings are read by post id once it is frozen
+				vector<int> sortedLevels(levels.size());
+				for(int i = 0; i < levels.size(); i++)
+					sortedLevels[i] = levels[i].second;
+				ImpactList* impacts = new ImpactList;
+				impacts->setLevels(sortedLevels, impactBits, step);
+				temp->setImpacts(impacts);
 			}
-			index->insert(temp);
+			if(!words.empty() && !(words.back()->getKey() < temp->getKey()))
+				sorted = false;	// the file was edited or its flag is wrong, insert the words one by one
+			words.push_back(temp);
+		}
+		if(sorted)
+			index->bulkLoad(words);
+		else
+		{
+			for(int i = 0; i < words.size(); i++)
+				index->insert(words[i]);
 		}
+		getline(infile, str);	// stored headers follow the words in files that have them
+		index->getDocuments().readFields(infile, str);
+		if(str.find("fields ") == 0)
+			getline(infile, str);	// then the hash a PerfectHashMap looks its words up by, if one wrote the file
+		index->readPerfectHash(infile, str);
+		index->getDocuments().readBodies(fileName + ".bodies");	// compressed bodies for snippets, if the index has them
+		index->setImpactScorer(impactScorer, impactBits);	// after the words, loading them would drop it
 	}
 	infile.close();
 }
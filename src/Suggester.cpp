@@ -0,0 +1,163 @@
+/*File: Suggester.cpp
+ *Project: Search Engine
+ *this file contains the functionality of Suggester.h
+ */
+
+#include "Suggester.h"
+#include <algorithm>
+
+using namespace std;
+
+bool suggestionOrder(const Suggester::Suggestion& i, const Suggester::Suggestion& j)
+{
+	if (i.edits != j.edits)
+		return i.edits < j.edits;
+	if (i.documents != j.documents)
+		return i.documents > j.documents;
+	return i.term < j.term;
+}
+
+Suggester::Suggester()
+{
+	dictionary = NULL;
+}
+
+Suggester::Suggester(TermDictionary* newDictionary)
+{
+	build(newDictionary);
+}
+
+void Suggester::build(TermDictionary* newDictionary)
+{
+	dictionary = newDictionary;
+	entries.clear();
+	vector<unsigned int> hashes;
+	for (int i = 0; i < dictionary->size(); i++)
+	{
+		if (Word::isFieldTerm(dictionary->term(i)))
+			continue;
+		deletesOf(dictionary->term(i), hashes);
+		for (int j = 0; j < hashes.size(); j++)
+		{
+			Entry entry;
+			entry.hash = hashes[j];
+			entry.term = i;
+			entries.push_back(entry);
+		}
+	}
+	sort(entries.begin(), entries.end());
+}
+
+/*
+ *a correction has at most MAX_EDITS edits, so it shares a delete of at most that many letters with
+ *the word that was typed. every term under one of the typed word's deletes is then checked by its
+ *real edit distance, which also weeds out the terms that only matched on the start or on a hash
+ */
+vector<Suggester::Suggestion> Suggester::suggest(const string& term, int minimumDocuments, int count)
+{
+	vector<Suggestion> suggestions;
+	if (dictionary == NULL || term.size() == 0)
+		return suggestions;
+	int limit = term.size() <= 4 ? 1 : MAX_EDITS;	//two edits away from a short word is almost any short word
+
+	vector<unsigned int> hashes;
+	deletesOf(term, hashes);
+	vector<int> candidates;
+	for (int i = 0; i < hashes.size(); i++)
+	{
+		Entry key;
+		key.hash = hashes[i];
+		key.term = -1;
+		for (vector<Entry>::iterator it = lower_bound(entries.begin(), entries.end(), key); it != entries.end() && it->hash == hashes[i]; it++)
+			candidates.push_back(it->term);
+	}
+	sort(candidates.begin(), candidates.end());
+	candidates.erase(unique(candidates.begin(), candidates.end()), candidates.end());
+
+	for (int i = 0; i < candidates.size(); i++)
+	{
+		const string& candidate = dictionary->term(candidates[i]);
+		int documents = dictionary->at(candidates[i])->getTotalNumberDocuments();
+		if (candidate == term || documents <= minimumDocuments)
+			continue;
+		int lengthDifference = (int)candidate.size() - (int)term.size();
+		if (lengthDifference > limit || -lengthDifference > limit)
+			continue;
+		int edits = editDistance(term, candidate, limit);
+		if (edits > limit)
+			continue;
+		Suggestion suggestion;
+		suggestion.term = candidate;
+		suggestion.edits = edits;
+		suggestion.documents = documents;
+		suggestions.push_back(suggestion);
+	}
+
+	sort(suggestions.begin(), suggestions.end(), suggestionOrder);
+	if (suggestions.size() > count)
+		suggestions.resize(count);
+	return suggestions;
+}
+
+int Suggester::bytes()
+{
+	return entries.size() * sizeof(Entry);
+}
+
+//hashes of the term's first PREFIX_LENGTH letters with zero, one and two of them deleted, without repeats
+void Suggester::deletesOf(const string& term, vector<unsigned int>& hashes)
+{
+	string prefix = term.substr(0, PREFIX_LENGTH);
+	int length = prefix.size();
+	hashes.clear();
+	hashes.push_back(hashOf(prefix, length, length));
+	for (int i = 0; i < length; i++)
+	{
+		hashes.push_back(hashOf(prefix, i, length));
+		for (int j = i + 1; j < length; j++)
+			hashes.push_back(hashOf(prefix, i, j));
+	}
+	sort(hashes.begin(), hashes.end());
+	hashes.erase(unique(hashes.begin(), hashes.end()), hashes.end());
+}
+
+//FNV-1a of the text without the letters at first and second, which may be past its end to keep them
+unsigned int Suggester::hashOf(const string& text, int first, int second)
+{
+	unsigned int hash = 2166136261U;
+	for (int i = 0; i < text.size(); i++)
+	{
+		if (i == first || i == second)
+			continue;
+		hash ^= (unsigned char)text[i];
+		hash *= 16777619U;
+	}
+	return hash;
+}
+
+//insertions, deletions, substitutions and swaps of neighbouring letters, anything over limit is returned as limit + 1
+int Suggester::editDistance(const string& a, const string& b, int limit)
+{
+	vector<int> beforeLast(b.size() + 1);
+	vector<int> last(b.size() + 1);
+	vector<int> row(b.size() + 1);
+	for (int j = 0; j <= b.size(); j++)
+		last[j] = j;
+	for (int i = 1; i <= a.size(); i++)
+	{
+		row[0] = i;
+		int best = row[0];
+		for (int j = 1; j <= b.size(); j++)
+		{
+			row[j] = min(min(last[j] + 1, row[j - 1] + 1), last[j - 1] + (a[i - 1] == b[j - 1] ? 0 : 1));
+			if (i > 1 && j > 1 && a[i - 1] == b[j - 2] && a[i - 2] == b[j - 1])
+				row[j] = min(row[j], beforeLast[j - 2] + 1);
+			best = min(best, row[j]);
+		}
+		if (best > limit)
+			return limit + 1;
+		beforeLast.swap(last);
+		last.swap(row);
+	}
+	return min(last[b.size()], limit + 1);
+}
@@ -0,0 +1,55 @@
+/*File: Suggester.h
+ *Project: Search Engine
+ *this file implements the "did you mean" corrections offered for query words that are missing or rare
+ *it is a symmetric delete index, every dictionary term is filed under the strings left by deleting up to
+ *two of its letters, so a misspelling finds its correction through a delete both share without trying every edit
+ */
+
+#ifndef SUGGESTER_H
+#define SUGGESTER_H
+
+#include <string>
+#include <vector>
+#include "TermDictionary.h"
+
+using namespace std;
+
+class Suggester
+{
+public:
+	struct Suggestion
+	{
+		string term;
+		int edits;
+		int documents;	// number of posts the term is found in
+	};
+
+	Suggester();
+	Suggester(TermDictionary* dictionary);
+
+	void build(TermDictionary* dictionary);	//header terms such as from:name are left out, they are only corrected through term~1
+	//up to count terms within MAX_EDITS of term found in more than minimumDocuments posts, fewest edits first and then the most common
+	vector<Suggestion> suggest(const string& term, int minimumDocuments, int count);
+	int bytes();
+
+	static const int MAX_EDITS = 2;
+
+private:
+	static const int PREFIX_LENGTH = 7;	//only the start of a long term is deleted from, the whole term is checked by edit distance
+
+	struct Entry
+	{
+		unsigned int hash;	//of the delete, two deletes sharing a hash only cost an extra edit distance check
+		int term;
+		bool operator<(const Entry& rhs) const { return hash < rhs.hash || (hash == rhs.hash && term < rhs.term); }
+	};
+
+	static void deletesOf(const string& term, vector<unsigned int>& hashes);
+	static unsigned int hashOf(const string& text, int first, int second);
+	static int editDistance(const string& a, const string& b, int limit);
+
+	TermDictionary* dictionary;
+	vector<Entry> entries;	//sorted by hash, so a lookup is a binary search
+};
+
+#endif
@@ -0,0 +1,113 @@
+/*File: TermDictionary.cpp
+ *Project: Search Engine
+ *this file contains the functionality of TermDictionary.h
+ */
+
+#include "TermDictionary.h"
+
+using namespace std;
+
+TermDictionary::TermDictionary()
+{
+
+}
+TermDictionary::TermDictionary(vector<Word*>& newWords)
+{
+	build(newWords);
+}
+void TermDictionary::build(vector<Word*>& newWords)
+{
+	words = newWords;
+	sort(words.begin(), words.end(), Word::keyLess);
+	terms.clear();
+	terms.reserve(words.size());
+	for(int i = 0; i < words.size(); i++)
+	{
+		terms.push_back(words[i]->getKey());
+		words[i]->setId(i);	//lets per word tables be plain arrays
+	}
+}
+int TermDictionary::size()
+{
+	return words.size();
+}
+Word* TermDictionary::at(int i)
+{
+	return words[i];
+}
+const string& TermDictionary::term(int i)
+{
+	return terms[i];
+}
+int TermDictionary::lowerBound(string_view key)
+{
+	return lower_bound(terms.begin(), terms.end(), key) - terms.begin();
+}
+void TermDictionary::prefixRange(string_view prefix, int& first, int& last)
+{
+	first = lowerBound(prefix);
+	int high = terms.size();
+	last = first;
+	while(last < high)	//binary search for the first term past the ones sharing the prefix
+	{
+		int middle = last + (high - last) / 2;
+		if(terms[middle].compare(0, prefix.size(), prefix) == 0)
+			last = middle + 1;
+		else
+			high = middle;
+	}
+}
+/*
+ *findWithin runs the Levenshtein automaton for key over the terms as if they were a trie. rows[d]
+ *is the row of edit distances after the first d letters of the current term, so a term only needs
+ *rows for the letters past the prefix it shares with the one before. once every value in a row is
+ *over maxEdits no term with that prefix can match and the whole prefix range is skipped
+ */
+void TermDictionary::findWithin(const string& key, int maxEdits, vector<Word*>& found, int limit)
+{
+	vector<vector<int> > rows(1, vector<int>(key.size() + 1));
+	for(int j = 0; j <= key.size(); j++)
+		rows[0][j] = j;
+	string previous = "";
+	bool field = Word::isFieldTerm(key);
+
+	int i = 0;
+	while(i < terms.size() && found.size() < limit)
+	{
+		const string& current = terms[i];
+		int shared = 0;
+		while(shared < previous.size() && shared < current.size() && previous[shared] == current[shared])
+			shared++;
+		rows.resize(shared + 1);
+
+		bool reachable = true;
+		for(int depth = shared; depth < current.size() && reachable; depth++)
+		{
+			vector<int>& above = rows[depth];
+			vector<int> row(key.size() + 1);
+			row[0] = above[0] + 1;
+			int best = row[0];
+			for(int j = 1; j <= key.size(); j++)
+			{
+				int substitute = above[j - 1] + (key[j - 1] == current[depth] ? 0 : 1);
+				row[j] = min(min(above[j] + 1, row[j - 1] + 1), substitute);
+				best = min(best, row[j]);
+			}
+			rows.push_back(row);
+			reachable = best <= maxEdits;
+		}
+
+		if(!reachable)
+		{
+			previous = current.substr(0, rows.size() - 1);
+			int first, last;
+			prefixRange(previous, first, last);
+			i = last;
+			continue;
+		}
+		if(rows.back()[key.size()] <= maxEdits && Word::isFieldTerm(current) == field)
+			found.push_back(words[i]);
+		previous = current;
+		i++;
+	}
+}
@@ -0,0 +1,39 @@
+/*File: TermDictionary.h
+ *Project: Search Engine
+ *this file implements a sorted array of the words in an index, used for range lookups
+ *such as prefix queries that a hash table or a plain tree search can't answer directly
+ *the sorted terms are also walked as a trie, neighbours share their common prefix, for fuzzy matching
+ */
+
+#ifndef TERMDICTIONARY_H
+#define TERMDICTIONARY_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Word.h"
+
+using namespace std;
+
+class TermDictionary
+{
+public:
+	TermDictionary();
+	TermDictionary(vector<Word*>& words);
+
+	void build(vector<Word*>& words);       //sorts the words, any order is accepted, and numbers them in that order
+	int size();
+	Word* at(int i);
+	const string& term(int i);
+	int lowerBound(string_view key);     //first term not less than key
+	void prefixRange(string_view prefix, int& first, int& last);  //terms in [first, last) start with prefix
+	//appends up to limit words within maxEdits insertions, deletions or substitutions of key,
+	//header terms only for a key that is one and body terms only for a key that isn't
+	void findWithin(const string& key, int maxEdits, vector<Word*>& found, int limit);
+
+private:
+	vector<string> terms;                   //kept apart from the words so a binary search only touches the keys
+	vector<Word*> words;
+};
+
+#endif
@@ -15,17 +15,16 @@ using namespace std;
 
 UI::UI(string indexType)
 {
-	if (indexType == "AVL")
-		F_ = new AVL;
-	else if (indexType == "HashMap")
-		F_ = new HashMap;
-	else
+	F_ = FileIndex::create(indexType);
+	if (F_ == NULL)
 	{
 		cerr << "A valid data structure was not selected" << endl;
 	}
 
 	sP_ = new SecondaryParser(F_);
 	Q_ = new QueryProcessor(F_, P_);
+	client_ = NULL;
+	pageStart_ = 0;
 
 	currentQuery_ = "";
 	currentScreen_ = "start";
@@ -35,15 +34,42 @@ UI::UI(string indexType)
 	debuggingPath2_ = "C:\\Users\\Mononoke\\Desktop\\documents\\Hartnett-Dobmeyer-Socha-IP-7\\data\\indexSingle.txt";
 }
 
+UI::UI(QueryClient* client)
+{
+	F_ = NULL;
+	sP_ = NULL;
+	Q_ = NULL;
+	client_ = client;
+	pageStart_ = 0;
+
+	currentQuery_ = "";
+	currentScreen_ = "start";
+	dataStructureType_ = "daemon";
+	indexFilePath_ = "";
+}
+
 UI::~UI()
 {
 	delete F_;
 	delete sP_;
 	delete Q_;
+	delete client_;
 }
 
 void UI::startUI()
 {
+	if (client_ != NULL)
+	{
+		clearScreen();
+		printTopBar();
+		cout << "**************************************************" << endl;
+		cout << endl;
+		cout << "Connected to the query daemon at " << client_->getAddress() << endl;
+		cout << endl;
+		bottomScreen();
+		return;
+	}
+
 	clearScreen();
 	cout << "Please enter the path to the file index: ";
 	getline(cin, indexFilePath_);
@@ -72,10 +98,7 @@ void UI::clearIndex()
 {
 	delete F_, sP_, Q_;
 
-	if (dataStructureType_ == "AVL")
-		F_ = new AVL;
-	else if (dataStructureType_ == "HashMap")
-		F_ = new HashMap;
+	F_ = FileIndex::create(dataStructureType_);
 
 	sP_ = new SecondaryParser(F_);
 	Q_ = new QueryProcessor(F_, P_);
@@ -101,20 +124,26 @@ void UI::displayResults()
 
 	cout << "* Results for: " << "\"" << currentQuery_ << "\"" << endl;
 	cout << "**************************************************" << endl;
+	for (int i = 0; i < suggestions_.size(); i++)
+		cout << "* Did you mean: " << suggestions_[i] << endl;
+	if (!suggestions_.empty())
+		cout << "**************************************************" << endl;
 	cout << endl;
 
-	vector<Word::File*> tempList = Q_->getFiles();
+	int displayEnd = pageStart_ + 15;
 
-	int displaySize = 15;
+	if (hits_.size() < displayEnd)
+		displayEnd = hits_.size();
 
-	if (tempList.size() < 15)
-		displaySize = tempList.size();
-
-	for (int i = 0; i < displaySize; i++)
+	for (int i = pageStart_; i < displayEnd; i++)
 	{
-		cout << "* " << (i + 1) << ": " << tempList[i]->fileName << endl;
-		cout << "*** " << tempList[i]->day << ", " << tempList[i]->strmonth << " " << tempList[i]->year << endl;
-		parseSenderAndGroup(tempList[i]->fileName);
+		cout << "* " << (i + 1) << ": " << hits_[i].fileName << endl;
+		cout << "*** " << hits_[i].day << ", " << hits_[i].strmonth << " " << hits_[i].year << endl;
+		cout << "*** Newsgroups: " << hits_[i].newsgroups << endl;
+		cout << "*** From: " << hits_[i].from << endl;
+		cout << "*** Subject: " << hits_[i].subject << endl;
+		if (hits_[i].snippet != "")
+			cout << "*** " << hits_[i].snippet << endl;
 		cout << endl;
 	}
 
@@ -128,7 +157,10 @@ void UI::bottomScreen()
 	cout << "**************************************************" << endl;
 	cout << "* Query Menu                              | oUSE *" << endl;
 	if (currentScreen_ == "displayResults")
+	{
 		cout << "* To open a result, type 'CMDOPEN'               *" << endl;
+		cout << "* For the next 15 results, type 'NEXT_PAGE'      *" << endl;
+	}
 	cout << "**************************************************" << endl;
 	cout << "Query: ";
 
@@ -139,6 +171,12 @@ void UI::bottomScreen()
 
 	if (temp == "ENTERCOMMAND")
 		commandScreen();
+	else if (client_ != NULL && needsLocalIndex(temp))
+	{
+		cout << temp << " is not available when connected to a daemon" << endl;
+		cout << endl;
+		bottomScreen();
+	}
 	else if (temp == "ADD_FILE_TO_INDEX")
 		parseNewFile();
 	else if (temp == "SWITCH_DATA_STRUCTURE")
@@ -147,6 +185,12 @@ void UI::bottomScreen()
 		writeIndexFile();
 	else if (temp == "CLEAR_INDEX")
 		clearIndex();
+	else if (temp == "SWITCH_SCORER")
+		switchScorer();
+	else if (temp == "QUANTIZE_IMPACTS")
+		quantizeImpacts();
+	else if (temp == "NEXT_PAGE")
+		nextPage();
 	else if (temp == "CMDOPEN")
 	{
 		cout << endl;
@@ -157,11 +201,82 @@ void UI::bottomScreen()
 	else
 	{
 		currentQuery_ = temp;
-		Q_->Query(currentQuery_);
+		runQuery(currentQuery_);
 		displayResults();
 	}
 }
 
+/**
+	runQuery fills hits_ with the first page from the local query processor, or with
+	every result the daemon sends when the UI is a thin client. spelling suggestions
+	need the index's dictionary, so only a local search offers them
+**/
+void UI::runQuery(string query)
+{
+	pageStart_ = 0;
+	nextPage_ = "";
+	suggestions_.clear();
+	if (client_ != NULL)
+	{
+		hits_ = client_->query(query);
+		return;
+	}
+
+	Q_->Query(query);
+	QueryProcessor::Page page = Q_->getPage(0, 15);
+	hits_.clear();
+	addHits(page.results);
+	nextPage_ = page.next;
+	suggestions_ = Q_->getSuggestions();
+}
+
+/**
+	nextPage moves the display on 15 results, asking the query processor to
+	rank the next page only when it hasn't been fetched yet
+**/
+void UI::nextPage()
+{
+	if (pageStart_ + 15 >= hits_.size() && nextPage_ != "" && client_ == NULL)
+	{
+		QueryProcessor::Page page = Q_->getPage(nextPage_, 15);
+		addHits(page.results);
+		nextPage_ = page.next;
+	}
+	if (pageStart_ + 15 < hits_.size())
+		pageStart_ += 15;
+	displayResults();
+}
+
+void UI::addHits(vector<QueryProcessor::Result>& results)
+{
+	for (int i = 0; i < results.size(); i++)
+	{
+		DocumentTable::Document& post = F_->getDocuments().get(results[i].docId);
+		QueryClient::Hit hit;
+		hit.fileName = post.fileName;
+		hit.score = results[i].score;
+		hit.year = post.year;
+		hit.strmonth = post.strmonth;
+		hit.day = post.day;
+		hit.from = F_->getDocuments().getField(results[i].docId, DocumentTable::FROM);
+		hit.subject = F_->getDocuments().getField(results[i].docId, DocumentTable::SUBJECT);
+		hit.newsgroups = F_->getDocuments().getField(results[i].docId, DocumentTable::NEWSGROUPS);
+		hit.messageId = F_->getDocuments().getField(results[i].docId, DocumentTable::MESSAGE_ID);
+		hit.snippet = Q_->getSnippet(results[i].docId);
+		hits_.push_back(hit);
+	}
+}
+
+/**
+	needsLocalIndex is true for the commands that change or save the index,
+	which a thin client can't do to the daemon's copy
+**/
+bool UI::needsLocalIndex(string command)
+{
+	return command == "ADD_FILE_TO_INDEX" || command == "SWITCH_DATA_STRUCTURE" || command == "WRITE_INDEX_TO_FILE"
+		|| command == "CLEAR_INDEX" || command == "SWITCH_SCORER" || command == "QUANTIZE_IMPACTS";
+}
+
 void UI::openResult(int resultNumber)
 {
 
@@ -170,12 +285,9 @@ void UI::openResult(int resultNumber)
 	cout << "* displaying result #" << resultNumber << endl;
 	cout << "**************************************************" << endl;
 
-	vector<Word::File*> tempList = Q_->getFiles();
-
-	Word::File* desiredFile = tempList[ (resultNumber - 1) ];
-
 	fstream myFile;
-	myFile.open(desiredFile->fileName);
+	if (resultNumber >= 1 && resultNumber <= hits_.size())
+		myFile.open(hits_[resultNumber - 1].fileName);
 
 	string tempLine = "";
 
@@ -207,6 +319,8 @@ void UI::commandScreen()
 	cout << "* 'SWITCH_DATA_STRUCTURE' -> re-parse in the index to test another data structure" << endl;
 	cout << "* 'WRITE_INDEX_TO_FILE' -> write the index to a new file" << endl;
 	cout << "* 'CLEAR_INDEX' -> delete the index" << endl;
+	cout << "* 'SWITCH_SCORER' -> rank results with BM25 or TFIDF" << endl;
+	cout << "* 'QUANTIZE_IMPACTS' -> store 8 or 16 bit scores with the postings to save memory" << endl;
 	cout << endl;
 
 	bottomScreen();
@@ -264,14 +378,7 @@ void UI::switchDataStructure()
 	cout << "NOTE: any alternative files added to index after main file must be re-imported!!!" << endl;
 	cout << endl;
 	cout << "Current Data Structure: " << dataStructureType_ << endl;
-	cout << "Switch to a ";
-
-	if (dataStructureType_ == "AVL")
-		cout << "HashMap";
-	else
-		cout << "AVL tree";
-
-	cout << "? (y/n): ";
+	cout << "Switch to a " << nextDataStructure() << "? (y/n): ";
 	string temp = "";
 	cin >> temp;
 	temp = tolower(temp[0]);
@@ -285,19 +392,32 @@ void UI::switchDataStructure()
 	bottomScreen();
 }
 
-void UI::performDataSwitch()
+/**
+	nextDataStructure is the structure a switch moves to, the switch goes
+	round from an AVL tree to a HashMap, a BTree, a FlatHashMap, an ART, a PerfectHashMap and back
+**/
+string UI::nextDataStructure()
 {
 	if (dataStructureType_ == "AVL")
-		dataStructureType_ = "HashMap";
-	else
-		dataStructureType_ = "AVL";
+		return "HashMap";
+	else if (dataStructureType_ == "HashMap")
+		return "BTree";
+	else if (dataStructureType_ == "BTree")
+		return "FlatHashMap";
+	else if (dataStructureType_ == "FlatHashMap")
+		return "ART";
+	else if (dataStructureType_ == "ART")
+		return "PerfectHashMap";
+	return "AVL";
+}
+
+void UI::performDataSwitch()
+{
+	dataStructureType_ = nextDataStructure();
 
 	delete F_, sP_, Q_;
 
-	if (dataStructureType_ == "AVL")
-		F_ = new AVL;
-	else
-		F_ = new HashMap;
+	F_ = FileIndex::create(dataStructureType_);
 
 	sP_ = new SecondaryParser(F_);
 	Q_ = new QueryProcessor(F_, P_);
@@ -307,6 +427,55 @@ void UI::performDataSwitch()
 	cout << "Done." << endl;
 }
 
+void UI::switchScorer()
+{
+	clearScreen();
+	printTopBar();
+	currentScreen_ = "switchScorer";
+
+	if (Q_->getScorer()->getName() == "BM25")
+		Q_->setScorer(new TfIdfScorer);
+	else
+		Q_->setScorer(new BM25Scorer);
+
+	cout << "* Results are now ranked with " << Q_->getScorer()->getName() << endl;
+	cout << "**************************************************" << endl;
+	cout << endl;
+
+	bottomScreen();
+}
+
+void UI::quantizeImpacts()
+{
+	clearScreen();
+	printTopBar();
+	currentScreen_ = "quantizeImpacts";
+	cout << "* Quantize Impact Scores                         *" << endl;
+	cout << "**************************************************" << endl;
+	cout << endl;
+	cout << "NOTE: scores are rounded for the current scorer, " << Q_->getScorer()->getName() << endl;
+	cout << "Bits per score (8/16, 0 to use exact scores again): ";
+	string bits = "";
+	cin >> bits;
+
+	if (bits == "8" || bits == "16")
+	{
+		cout << "Scale per word or global? (w/g): ";
+		string scale = "";
+		cin >> scale;
+		ImpactList::quantizeIndex(F_, Q_->getScorer(), atoi(bits.c_str()), scale == "w");
+		cout << "Impacts quantized to " << bits << " bits, the index is now written with them in place of exact scores." << endl;
+	}
+	else
+	{
+		ImpactList::dropIndex(F_);
+		cout << "Using exact scores." << endl;
+	}
+
+	cout << endl;
+	bottomScreen();
+}
+
 void UI::writeIndexFile()
 {
 	clearScreen();
@@ -329,69 +498,3 @@ void UI::writeIndexFile()
 
 	bottomScreen();
 }
-
-void UI::parseSenderAndGroup(string fileName)
-{
-		fstream myFile;
-
-		string groupName = "";
-		string from = "";
-		string subject = "";
-
-		myFile.open(fileName);
-
-		if (!myFile.is_open())
-		{
-			cerr << "There was a problem opening file: " << fileName << endl;
-			//break; // if we decided to break out of entire parsing operation for each error
-		}
-
-		int fieldCount = 1;
-
-		bool finished = false;
-
-		while (!myFile.eof() && !finished)
-		{
-			string tempLine = "";
-			getline(myFile, tempLine);
-			string tempWord = "";
-
-			switch (fieldCount)	// this is to help determine what metadata is currently laoded, and proceed properly
-			{
-				case 1 :
-				{
-					if (tempLine.find("From:") == 0)
-					{
-						fieldCount = 2;
-						from = tempLine;
-					}
-					break;
-				}
-				case 2 :
-				{
-					if (tempLine.find("Newsgroups:") == 0)
-					{
-						fieldCount = 3;
-						groupName = tempLine;
-					}
-					break;
-				}
-				case 3 :
-				{
-					if (tempLine.find("Subject:") == 0)
-					{
-						fieldCount = 4;
-						subject = tempLine;
-						finished = true;
-					}
-					break;
-
-				}
-				default: cout << "ERROR" << endl; break;	// meta data has somehow ben skipped or mishandled
-			}
-		}	// end while(!myFile.eof())
-
-		cout << "*** " << groupName << endl;
-		cout << "*** " << from << endl;
-		cout << "*** " << subject << endl;
-}
@@ -20,6 +20,7 @@
 #include "SecondaryParser.h"
 #include "Parser.h"
 #include "QueryProcessor.h"
+#include "QueryClient.h"
 
 using namespace std;
 
@@ -27,6 +28,7 @@ class UI
 {
 	public:
 		UI(string);
+		UI(QueryClient*);		// thin client, queries are answered by a running daemon
 		~UI();
 		void startUI();
 
@@ -38,12 +40,18 @@ class UI
 		void commandScreen();
 		void parseNewFile();
 		void switchDataStructure();
+		void switchScorer();
+		void quantizeImpacts();
 		void clearScreen();
 		void performDataSwitch();
+		string nextDataStructure();
 		void openResult(int);
 		void writeIndexFile();
-		void parseSenderAndGroup(string);
 		void clearIndex();
+		void runQuery(string);
+		void nextPage();
+		void addHits(vector<QueryProcessor::Result>&);
+		bool needsLocalIndex(string);
 
 		string currentQuery_;
 		string currentScreen_;
@@ -56,6 +64,11 @@ class UI
 		FileIndex* F_;
 		QueryProcessor* Q_;
 		SecondaryParser* sP_;
+		QueryClient* client_;
+		vector<QueryClient::Hit> hits_;		// results fetched so far, a page at a time when searching locally
+		int pageStart_;
+		string nextPage_;					// token for the results after hits_, empty once they are all fetched
+		vector<string> suggestions_;		// corrected queries, offered when the query found little
 
 };
 #endif
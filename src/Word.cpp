@@ -5,26 +5,64 @@
  */
 
 #include "Word.h"
-//#include <math.h>
+#include <math.h>
+#include <assert.h>
+#include <sstream>
+#include <new>
 
 using namespace std;
 
 bool myFunction(Word::File* i, Word::File* j) {return *i>*j;}
+bool scoreAbove(const pair<double, int>& i, const pair<double, int>& j) {return i.first > j.first;}
 
 Word::Word()
 {
-
+	arena = NULL;
+	id = -1;
+	impacts = NULL;
+	bitmap = NULL;
+	frozen = false;
 }
 Word::Word(string newWord)
 {
 	word = newWord;
+	arena = NULL;
+	id = -1;
+	impacts = NULL;
+	bitmap = NULL;
+	frozen = false;
+}
+Word::Word(string newWord, Arena* newArena)
+{
+	word = newWord;
+	arena = newArena;
+	id = -1;
+	impacts = NULL;
+	bitmap = NULL;
+	frozen = false;
 }
 Word::~Word()
+{
+	delete impacts;
+	delete bitmap;
+	deleteFiles();
+}
+void Word::deleteFiles()
 {
 	for(int i = 0; i < ranking.size(); i++)
 	{
-		delete ranking[i];
+		if(arena != NULL)
+			ranking[i]->~File();	// the memory goes back with the arena's chunks
+		else
+			delete ranking[i];
 	}
+	vector<File*>().swap(ranking);
+}
+Word::File* Word::newFile()
+{
+	if(arena != NULL)
+		return new (arena->allocate(sizeof(File))) File;
+	return new File;
 }
 void Word::setWord(string newWord)
 {
@@ -34,9 +72,119 @@ string Word::getWord()
 {
 	return word;
 }
-void Word::addFile(string newFileName)
+Arena* Word::getArena()
+{
+	return arena;
+}
+const string& Word::getKey()
+{
+	return word;
+}
+int Word::getId()
+{
+	return id;
+}
+void Word::setId(int newId)
+{
+	id = newId;
+}
+ImpactList* Word::getImpacts()
+{
+	return impacts;
+}
+void Word::setImpacts(ImpactList* newImpacts)
+{
+	delete impacts;
+	impacts = newImpacts;
+}
+Bitmap* Word::getBitmap()
+{
+	if(bitmap == NULL || !frozen || bitmap->cardinality() != docIds.size())
+		return NULL;
+	return bitmap;
+}
+void Word::buildBitmap()
+{
+	dropBitmap();
+	freeze(false);	//the bitmap's ranks are positions in the postings
+	for(int i = 0; i < docIds.size(); i++)
+	{
+		if(docIds[i] < 0 || (i > 0 && docIds[i] == docIds[i - 1]))
+			return;	//files that aren't in a document table yet can't be put in a bitmap
+	}
+	bitmap = new Bitmap;
+	bitmap->build(docIds);
+}
+void Word::dropBitmap()
+{
+	delete bitmap;
+	bitmap = NULL;
+}
+bool docIdFunction(Word::File* i, Word::File* j) {return i->docId < j->docId;}
+void Word::freeze(bool rankByImpact)
 {
-	File* temp = new File;
+	if(!frozen)
+	{
+		sort(ranking.begin(), ranking.end(), docIdFunction);
+		docIds.resize(ranking.size());
+		frequencies.resize(ranking.size());
+		scores.resize(ranking.size());
+		positionsAt.resize(ranking.size() + 1);
+		for(int i = 0; i < ranking.size(); i++)
+		{
+			docIds[i] = ranking[i]->docId;
+			frequencies[i] = ranking[i]->numberOfAppearances;
+			scores[i] = ranking[i]->TFIDF;
+			positionsAt[i] = positions.size();
+			positions += ranking[i]->positions;
+		}
+		positionsAt.back() = positions.size();
+		if(positions.empty())
+			positionsAt.clear();
+		deleteFiles();	// the names and dates were only copies of the document table's
+		frozen = true;
+	}
+	if(rankByImpact && byImpact.size() != docIds.size())
+		rankTFIDF();
+}
+bool Word::isFrozen() const
+{
+	return frozen;
+}
+void Word::takeFiles(Word* other)
+{
+	thaw();
+	other->thaw();
+	for(int i = 0; i < other->ranking.size(); i++)
+		ranking.push_back(other->ranking[i]);
+	other->ranking.clear();
+}
+void Word::thaw()
+{
+	for(int i = 0; i < docIds.size(); i++)
+	{
+		File* temp = newFile();
+		temp->docId = docIds[i];
+		temp->TFIDF = scores[i];
+		temp->numberOfAppearances = frequencies[i];
+		temp->totalWordsInFile = 0;	// the post's length and date are in the document table
+		temp->year = 0;
+		temp->month = 0;
+		temp->day = 0;
+		temp->positions = codedPositions(i);
+		ranking.push_back(temp);
+	}
+	frozen = false;
+	byImpact.clear();
+	docIds.clear();
+	frequencies.clear();
+	scores.clear();
+	positions.clear();
+	positionsAt.clear();
+}
+Word::File* Word::addFile(string newFileName)
+{
+	File* temp = newFile();
 	temp->fileName = newFileName;
 	temp->TFIDF = 0;
 	temp->numberOfAppearances = 1;
@@ -45,10 +193,12 @@ void Word::addFile(string newFileName)
 	temp->month = 0;
 	temp->day = 0;
 	ranking.push_back(temp);
+	thaw();
+	return temp;
 }
-void Word::addFile(string newFileName, int year, string month, int day)
+Word::File* Word::addFile(string newFileName, int year, string month, int day)
 {
-	File* temp = new File;
+	File* temp = newFile();
 	temp->fileName = newFileName;
 	temp->TFIDF = 0;
 	temp->numberOfAppearances = 1;
@@ -57,19 +207,23 @@ void Word::addFile(string newFileName, int year, string month, int day)
 	temp->strmonth = month;
 	temp->day = day;
 	ranking.push_back(temp);
+	thaw();
+	return temp;
 }
-void Word::addFile(string newFileName, double newTFIDF)
+Word::File* Word::addFile(string newFileName, double newTFIDF)
 {
-	File* temp = new File;
+	File* temp = newFile();
 	temp->fileName = newFileName;
 	temp->TFIDF = newTFIDF;
 	temp->numberOfAppearances = 1;
 	temp->totalWordsInFile = 1;
 	ranking.push_back(temp);
+	thaw();
+	return temp;
 }
-void Word::addFile(string newFileName, double newTFIDF, int newNumberAppearances)
+Word::File* Word::addFile(string newFileName, double newTFIDF, int newNumberAppearances)
 {
-	File* temp = new File;
+	File* temp = newFile();
 	temp->fileName = newFileName;
 	temp->TFIDF = newTFIDF;
 	temp->numberOfAppearances = newNumberAppearances;
@@ -78,10 +232,12 @@ void Word::addFile(string newFileName, double newTFIDF, int newNumberAppearances
 	temp->month = 0;
 	temp->day = 0;
 	ranking.push_back(temp);
+	thaw();
+	return temp;
 }
-void Word::addFile(string newFileName, double newTFIDF, int newNumberAppearances, int newTotalWordsInFile)
+Word::File* Word::addFile(string newFileName, double newTFIDF, int newNumberAppearances, int newTotalWordsInFile)
 {
-	File* temp = new File;
+	File* temp = newFile();
 	temp->fileName = newFileName;
 	temp->TFIDF = newTFIDF;
 	temp->numberOfAppearances = newNumberAppearances;
@@ -90,10 +246,12 @@ void Word::addFile(string newFileName, double newTFIDF, int newNumberAppearances
 	temp->month = 0;
 	temp->day = 0;
 	ranking.push_back(temp);
+	thaw();
+	return temp;
 }
-void Word::addFile(string newFileName, double newTFIDF, int newNumberAppearances, int newTotalWordsInFile, int newYear, int newMonth, int newDay)
+Word::File* Word::addFile(string newFileName, double newTFIDF, int newNumberAppearances, int newTotalWordsInFile, int newYear, int newMonth, int newDay)
 {
-	File* temp = new File;
+	File* temp = newFile();
 	temp->fileName = newFileName;
 	temp->TFIDF = newTFIDF;
 	temp->numberOfAppearances = newNumberAppearances;
@@ -102,10 +260,26 @@ void Word::addFile(string newFileName, double newTFIDF, int newNumberAppearances
 	temp->month = newMonth;
 	temp->day = newDay;
 	ranking.push_back(temp);
+	thaw();
+	return temp;
+}
+Word::File* Word::addPosting(int docId, double newTFIDF, int newNumberAppearances)
+{
+	File* temp = newFile();
+	temp->docId = docId;
+	temp->TFIDF = newTFIDF;
+	temp->numberOfAppearances = newNumberAppearances;
+	temp->totalWordsInFile = 0;
+	temp->year = 0;
+	temp->month = 0;
+	temp->day = 0;
+	ranking.push_back(temp);
+	thaw();
+	return temp;
 }
-void Word::addFile(string newFileName, double newTFIDF, int newNumberAppearances, int newTotalWordsInFile, int newYear, string newMonth, int newDay)
+Word::File* Word::addFile(string newFileName, double newTFIDF, int newNumberAppearances, int newTotalWordsInFile, int newYear, string newMonth, int newDay)
 {
-	File* temp = new File;
+	File* temp = newFile();
 	temp->fileName = newFileName;
 	temp->TFIDF = newTFIDF;
 	temp->numberOfAppearances = newNumberAppearances;
@@ -115,10 +289,23 @@ void Word::addFile(string newFileName, double newTFIDF, int newNumberAppearances
 	temp->strmonth = newMonth;
 	temp->day = newDay;
 	ranking.push_back(temp);
+	thaw();
+	return temp;
 }
+//a frozen word keeps its postings in post id order and is ranked by their numbers in byImpact
 void Word::rankTFIDF()
 {
-	vector<File*> copyVector;
+	if(frozen)
+	{
+		vector<pair<double, int> > ranked(docIds.size());
+		for(int i = 0; i < docIds.size(); i++)
+			ranked[i] = make_pair(scores[i], i);
+		sort(ranked.begin(), ranked.end(), scoreAbove);
+		byImpact.resize(ranked.size());
+		for(int i = 0; i < ranked.size(); i++)
+			byImpact[i] = ranked[i].second;
+		return;
+	}
 	sort(ranking.begin(), ranking.end(), myFunction);
 /*
 	for(int i = 0; i < ranking.size(); i++)
@@ -132,19 +319,182 @@ void Word::calculateTFIDF(int totalNumberOfDocuments)
 	for(int i = 0; i < ranking.size(); i++)
 	{
 		//term frequency calculation
-		ranking[i]->TFIDF = (double)ranking[i]->numberOfAppearances / (double)ranking[i]->totalWordsInFile * log10((double)totalNumberOfDocuments / (double)ranking.size());
+		ranking[i]->TFIDF = (double)ranking[i]->numberOfAppearances / (double)max(ranking[i]->totalWordsInFile, 1) * log10((double)totalNumberOfDocuments / (double)ranking.size());
 	}
 	rankTFIDF();//sorts the containing vector
 }
 int Word::getTotalNumberDocuments()
 {
-	return ranking.size();
+	return frozen ? docIds.size() : ranking.size();
 }
 vector<Word::File*>& Word::getRanking()
 {
+	assert(!frozen);
 	rankTFIDF();
 	return ranking;
 }
+const vector<int>& Word::getRankOrder()
+{
+	assert(frozen);
+	if(byImpact.size() != docIds.size())
+		rankTFIDF();
+	return byImpact;
+}
+vector<Word::File*>& Word::getPostings()
+{
+	return ranking;
+}
+const vector<int>& Word::getDocIds() const
+{
+	assert(frozen);
+	return docIds;
+}
+const vector<int>& Word::getFrequencies() const
+{
+	assert(frozen);
+	return frequencies;
+}
+const vector<double>& Word::getScores() const
+{
+	assert(frozen);
+	return scores;
+}
+void Word::setScore(int posting, double score)
+{
+	scores[posting] = score;
+}
+vector<int> Word::getPositions(int posting)
+{
+	return decodeGaps(codedPositions(posting));
+}
+string Word::codedPositions(int posting)
+{
+	if(positionsAt.empty())
+		return "";
+	return positions.substr(positionsAt[posting], positionsAt[posting + 1] - positionsAt[posting]);
+}
+void Word::write(ostream& out, bool withPositions, bool withImpacts, DocumentTable* documents)
+{
+	assert(!withImpacts || (frozen && impacts != NULL && impacts->size() == docIds.size()));
+	assert(!frozen || documents != NULL);	// a frozen word's postings keep only their post ids
+	out << word << "\n";                      //writes word to file
+	out << getTotalNumberDocuments() << "\n";            //writes number of files to document
+	if(withImpacts)
+	{
+		streamsize precision = out.precision(9);	// enough for the float step to read back the same
+		out << impacts->getStep() << "\n";	// score of one impact level
+		out.precision(precision);
+	}
+	if(frozen)
+	{
+		const vector<int>& order = getRankOrder();
+		for(int k = 0; k < docIds.size(); k++)
+		{
+			int i = withImpacts ? k : order[k];	// the impacts are in post id order
+			DocumentTable::Document& post = documents->get(docIds[i]);
+			out << post.fileName << "\n";  //writes the filename to document
+			if(withImpacts)
+				out << impacts->level(i) << "\n";	// impact level
+			else
+				out << scores[i] << "\n";      //TFIDF
+			out << frequencies[i] << "\n";  //number of appearances in that particular file
+			out << post.length << "\n";    //total words in the file
+			out << post.year << "\n";	// year of post
+			out << post.strmonth << "\n";	// month of post
+			out << post.day << "\n";		// day of post
+			if(withPositions)
+				out << positionsToText(codedPositions(i)) << "\n";	// word offsets in the post body
+		}
+		return;
+	}
+	vector<File*>& files = getRanking();
+	for(int i = 0; i < files.size(); i++)
+	{
+		bool named = documents == NULL || !files[i]->fileName.empty();	// postings loaded into an index leave the post's values to its document table
+		DocumentTable::Document* post = named ? NULL : &documents->get(files[i]->docId);
+		out << (named ? files[i]->fileName : post->fileName) << "\n";  //writes the filename to document
+		out << files[i]->TFIDF << "\n";      //TFIDF
+		out << files[i]->numberOfAppearances << "\n";  //number of appearances in that particular file
+		out << (named ? files[i]->totalWordsInFile : post->length) << "\n";    //total words in the file
+		out << (named ? files[i]->year : post->year) << "\n";	// year of post
+		out << (named ? files[i]->strmonth : post->strmonth) << "\n";	// month of post
+		out << (named ? files[i]->day : post->day) << "\n";		// day of post
+		if(withPositions)
+			out << positionsToText(files[i]->positions) << "\n";	// word offsets in the post body
+	}
+}
+/*
+ *ascending numbers such as word offsets are kept as the gaps between them, seven bits per byte
+ *with the high bit set on every byte but the last one of a gap
+ */
+string Word::encodeGaps(const vector<int>& numbers)
+{
+	string out;
+	int last = 0;
+	for(int i = 0; i < numbers.size(); i++)
+	{
+		unsigned int gap = numbers[i] - last;
+		last = numbers[i];
+		while(gap >= 0x80)
+		{
+			out += (char)((gap & 0x7F) | 0x80);
+			gap >>= 7;
+		}
+		out += (char)gap;
+	}
+	return out;
+}
+vector<int> Word::decodeGaps(const string& gaps)
+{
+	vector<int> out;
+	int last = 0;
+	unsigned int gap = 0;
+	int shift = 0;
+	for(int i = 0; i < gaps.size(); i++)
+	{
+		unsigned char byte = gaps[i];
+		gap |= (unsigned int)(byte & 0x7F) << shift;
+		if(byte & 0x80)
+		{
+			shift += 7;
+		}
+		else
+		{
+			last += gap;
+			out.push_back(last);
+			gap = 0;
+			shift = 0;
+		}
+	}
+	return out;
+}
+string Word::positionsToText(const string& positions)
+{
+	vector<int> decoded = decodeGaps(positions);
+	stringstream out;
+	int last = 0;
+	for(int i = 0; i < decoded.size(); i++)
+	{
+		if(i > 0)
+			out << " ";
+		out << decoded[i] - last;
+		last = decoded[i];
+	}
+	return out.str();
+}
+string Word::positionsFromText(const string& line)
+{
+	stringstream in(line);
+	vector<int> decoded;
+	int gap;
+	int last = 0;
+	while(in >> gap)
+	{
+		last += gap;
+		decoded.push_back(last);
+	}
+	return encodeGaps(decoded);
+}
 int Word::calculateMonth(string month)
 {
 	for(int i = 0; i < month.size(); i++)
@@ -163,4 +513,20 @@ int Word::calculateMonth(string month)
 	else if(month == "oct") return 10;
 	else if(month == "nov") return 11;
 	else if(month == "dec") return 12;
+	return 0;	// not a month, as for the empty month of a posting whose month's text is kept in the document table
+}
+bool Word::keyLess(Word* i, Word* j)
+{
+	return i->getKey() < j->getKey();
+}
+bool Word::isFieldTerm(string_view key)
+{
+	return key.substr(0, 5) == "from:" || key.substr(0, 6) == "group:" || key.substr(0, 8) == "subject:";
+}
+unsigned long long Word::packLetters(string_view key, int start)
+{
+	unsigned long long letters = 0;
+	for(int i = start; i < start + 8; i++)
+		letters = (letters << 8) | (i < key.size() ? (unsigned char)key[i] : 0);
+	return letters;
 }
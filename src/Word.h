@@ -9,21 +9,31 @@
 
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <algorithm>
+#include "ImpactList.h"
+#include "Bitmap.h"
+#include "Arena.h"
+#include "DocumentTable.h"
 
 using namespace std;
 
 class Word
 {
 public:
+	// a posting while the word is built. the index's words keep only the post id, score, appearances
+	// and positions of each, in the arrays freeze fills, the rest is the post's row in the document table
 	struct File {
+		File() { docId = -1; }
 		string fileName;
+		int docId;	// id of the post in the index's document table, -1 until the file is loaded into an index
 		int numberOfAppearances;
 		double TFIDF;
 		int totalWordsInFile;
 		int year, month, day;
 		string strmonth;
+		string positions;	// varint coded gaps between word offsets, empty unless the index stores positions
 		bool operator<(const File& rhs)
 		{
 			return this->TFIDF < rhs.TFIDF;
@@ -45,26 +55,81 @@ public:
 	Word(); 
 	Word(string newWord);
 	Word(string newWord, double newTFIDF);
+	Word(string newWord, Arena* newArena);	// files are then allocated in the arena, which frees their memory with its chunks
 	~Word();
 	void setWord(string newWord);
 	string getWord();
+	const string& getKey();	// the word without the copy getWord makes, for the comparisons inside index structures
+	Arena* getArena();	// NULL for a word whose files are on the heap
+	int getId();	// position in the index's sorted dictionary, -1 for words that aren't in one
+	void setId(int newId);
+	ImpactList* getImpacts();	// quantized copy of the postings' scores, NULL unless the index was quantized
+	void setImpacts(ImpactList* newImpacts);	// takes ownership
+	Bitmap* getBitmap();	// post ids of a word found in many posts, NULL for other words or once files were added after it was built
+	void buildBitmap();
+	void dropBitmap();
 	void rankTFIDF();
 	void calculateTFIDF(int totalNumberOfDocuments);
-	void addFile(string newFileName);
-	void addFile(string newFileName, int year, string month, int day);
-	void addFile(string newFileName, double newTFIDF);
-	void addFile(string newFileName, double newTFIDF, int newNumberAppearances);
-	void addFile(string newFileName, double newTFIDF, int newNumberAppearances, int newTotalWordsInFile);
-	void addFile(string newFileName, double newTFIDF, int newNumberAppearances, int newTotalWordsInFile, int year, int month, int day);
-	void addFile(string newFileName, double newTFIDF, int newNumberAppearances, int newTotalWordsInFile, int year, string month, int day);
+	File* addFile(string newFileName);
+	File* addFile(string newFileName, int year, string month, int day);
+	File* addFile(string newFileName, double newTFIDF);
+	File* addFile(string newFileName, double newTFIDF, int newNumberAppearances);
+	File* addFile(string newFileName, double newTFIDF, int newNumberAppearances, int newTotalWordsInFile);
+	File* addFile(string newFileName, double newTFIDF, int newNumberAppearances, int newTotalWordsInFile, int year, int month, int day);
+	File* addFile(string newFileName, double newTFIDF, int newNumberAppearances, int newTotalWordsInFile, int year, string month, int day);
+	File* addPosting(int docId, double newTFIDF, int newNumberAppearances);	// a post already in a document table, which keeps its name, length and date
 	int calculateMonth(string month);
 	int getTotalNumberDocuments();
-	vector<File*>& getRanking();
+	void takeFiles(Word* other);	// moves other's files to this word, for a word inserted twice, other is left with none
+
+	// the postings are built, then frozen. files are added while the index is built, in any order, and
+	// freeze sorts them by post id once, copies them into the arrays below and frees them. from then on
+	// the word only reads those arrays, until a file is added again and they are turned back into files.
+	// the index freezes its words when it builds its dictionary, before any query reads them, so many
+	// queries can read a word at once. only words whose posts are in a document table are frozen
+	void freeze(bool rankByImpact);	// rankByImpact also keeps getRankOrder, a frozen word is left as it is
+	bool isFrozen() const;
+	vector<File*>& getRanking();	// best TFIDF first, the files of a word that isn't frozen
+	vector<File*>& getPostings();	// the files of a word that isn't frozen in the order they were added, empty once it is
+	const vector<int>& getRankOrder();	// posting numbers in the arrays below best score first, only for a frozen word
+	const vector<int>& getDocIds() const;	// the postings' post ids as one array in post id order, only for a frozen word
+	const vector<int>& getFrequencies() const;	// their numbers of appearances, entry i is for getDocIds()[i]
+	const vector<double>& getScores() const;	// their TFIDF, or the score of their impact once the index is quantized
+	void setScore(int posting, double score);
+	vector<int> getPositions(int posting);	// word offsets in the post, empty unless the index stores positions
+	// writes the word and its postings in index file format, names left empty are looked up in documents,
+	// as is every post of a frozen word.
+	// withImpacts writes the word's step and then each posting's impact in place of its score, the word
+	// has to be frozen with impacts for its postings, as the index's words are once they are quantized
+	void write(ostream& out, bool withPositions, bool withImpacts, DocumentTable* documents = NULL);
+
+	static string encodeGaps(const vector<int>& numbers);	// ascending numbers as varint coded gaps
+	static vector<int> decodeGaps(const string& gaps);
+	static string positionsToText(const string& positions);	// gaps as a space separated line for the index file
+	static string positionsFromText(const string& line);
+	static unsigned long long packLetters(string_view key, int start);	// eight letters from start, zero padded and big endian so the numbers sort like the letters
+	static bool keyLess(Word* i, Word* j);	// orders words by their text, the order index files are written in
+	static bool isFieldTerm(string_view key);	// a term indexed from a header, from:, group: or subject: and a token
 	
 private:
+	File* newFile();
+	void deleteFiles();
+	string codedPositions(int posting);	// a frozen posting's gaps, as File::positions holds them
+	void thaw();	// a file was added, the word is built again from its arrays
 	
 	string word;
-	vector<File*> ranking;
+	Arena* arena;
+	int id;
+	ImpactList* impacts;
+	Bitmap* bitmap;
+	vector<File*> ranking;	// the postings while the word is built, owned by the word
+	vector<int> byImpact;	// getRankOrder, only for a frozen word
+	bool frozen;	// the postings are in the arrays below in post id order
+	vector<int> docIds;	// the postings side by side, so the loops that score a word stream through
+	vector<int> frequencies;	// arrays instead of following a pointer a posting
+	vector<double> scores;
+	string positions;	// every posting's coded gaps back to back
+	vector<int> positionsAt;	// where each posting's gaps start in positions, and where they end last, empty when none has any
 };
 
 #endif
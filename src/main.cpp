@@ -7,13 +7,35 @@
 #include "Parser.h"
 #include "QueryProcessor.h"
 #include "UI.h"
+#include "QueryServer.h"
+#include "QueryDaemon.h"
+#include "QueryClient.h"
+#include "BatchRunner.h"
+#include "ImpactList.h"
+#include <deque>
+#include <fstream>
+#include <signal.h>
 
 using namespace std;
 
 void parseFilesFirst();
+void quantizeIndexFile(string fileName, int bits, bool perWordScale);
+int serveQueries(int argc, char* argv[]);
+int runDaemon(int argc, char* argv[]);
+int runBatch(int argc, char* argv[]);
+int connectToDaemon(int argc, char* argv[]);
 
-int main()
+int main(int argc, char* argv[])
 {
+	if (argc > 1 && string(argv[1]) == "--serve")
+		return serveQueries(argc, argv);
+	if (argc > 1 && string(argv[1]) == "--batch")
+		return runBatch(argc, argv);
+	if (argc > 1 && string(argv[1]) == "--daemon")
+		return runDaemon(argc, argv);
+	if (argc > 1 && string(argv[1]) == "--connect")
+		return connectToDaemon(argc, argv);
+
 	#if defined (_MSC_VER)
 			system("cls");
 	#else
@@ -33,7 +55,7 @@ int main()
 			system("clear");
 	#endif
 
-	cout << "Please select either AVL or HashMap" << endl;
+	cout << "Please select AVL, HashMap, BTree, FlatHashMap, ART or PerfectHashMap" << endl;
 	temp = "";
 	cin >> temp;
 
@@ -51,7 +73,254 @@ void parseFilesFirst()
 	string inputFilePath = "";
 	getline(cin, inputFilePath);
 	getline(cin, inputFilePath);
+	cout << "store word positions for \"phrase\" queries and snippets? (y/n): ";
+	string storePositions = "";
+	getline(cin, storePositions);
+	myParser.setStorePositions(storePositions == "y");
+	cout << "bits per impact score for a smaller index (8/16, 0 to keep exact scores): ";
+	string bits = "";
+	getline(cin, bits);
+	string scale = "";
+	if (bits == "8" || bits == "16")
+	{
+		cout << "scale per word or global? (w/g): ";
+		getline(cin, scale);
+	}
 	myParser.setNumberOfFiles(21);
 	myParser.parseFiles(inputFilePath);
+
+	if (bits == "8" || bits == "16")
+		quantizeIndexFile(myParser.getIndexPath(), atoi(bits.c_str()), scale == "w");
+}
+
+/**
+	quantizeIndexFile rewrites an index with its postings' scores rounded to impacts
+	for the default ranking, BM25, which replace the exact scores in the file
+**/
+void quantizeIndexFile(string fileName, int bits, bool perWordScale)
+{
+	FileIndex* index = FileIndex::create("HashMap");
+	SecondaryParser secondaryParser(index);
+	secondaryParser.parseFile(fileName);
+	BM25Scorer scorer;
+	ImpactList::quantizeIndex(index, &scorer, bits, perWordScale);
+	index->writeToFile(fileName);
+	delete index;
+}
+
+
+/**
+	serveQueries answers the queries read from standard input, one per line,
+	with a pool of threads sharing one index. Several queries are in flight at
+	once, and their results are printed in the order the queries arrived.
+
+	usage: oUSE --serve <index file> [AVL|HashMap|BTree|FlatHashMap|ART|PerfectHashMap] [threads]
+**/
+int serveQueries(int argc, char* argv[])
+{
+	if (argc < 3)
+	{
+		cerr << "usage: " << argv[0] << " --serve <index file> [AVL|HashMap|BTree|FlatHashMap|ART|PerfectHashMap] [threads]" << endl;
+		return 1;
+	}
+	string indexType = "HashMap";
+	if (argc > 3)
+		indexType = argv[3];
+	int numberOfThreads = 0;
+	if (argc > 4)
+		numberOfThreads = atoi(argv[4]);
+
+	FileIndex* index = FileIndex::create(indexType);
+	if (index == NULL)
+	{
+		cerr << "A valid data structure was not selected" << endl;
+		return 1;
+	}
+	SecondaryParser secondaryParser(index);
+	secondaryParser.parseFile(argv[2]);
+
+	QueryServer* server = new QueryServer(index, numberOfThreads);
+	int window = server->getNumberOfThreads() * 4;	// queries allowed in flight before the oldest is printed
+
+	deque<pair<string, future<QueryServer::Results> > > pending;
+	string query;
+	bool reading = true;
+	while (reading || !pending.empty())
+	{
+		if (reading && getline(cin, query))
+		{
+			if (query != "")
+				pending.push_back(make_pair(query, server->submit(query, 10)));
+			if (pending.size() < window)
+				continue;
+		}
+		else
+			reading = false;
+
+		if (pending.empty())
+			continue;
+		QueryServer::Results results = pending.front().second.get();
+		cout << "# " << pending.front().first << endl;
+		for (int i = 0; i < results.size(); i++)
+			cout << index->getDocuments().get(results[i].docId).fileName << "\t" << results[i].score << endl;
+		cout << endl;
+		pending.pop_front();
+	}
+
+	delete server;
+	delete index;
+	return 0;
+}
+
+/**
+	runBatch runs every query of a file, or of standard input when the file is "-",
+	writes the top k results of each to standard output and ends with a latency and
+	throughput report on standard error
+
+	usage: oUSE --batch <index file> <queries file|-> [AVL|HashMap|BTree|FlatHashMap|ART|PerfectHashMap] [threads] [clients] [k]
+**/
+int runBatch(int argc, char* argv[])
+{
+	if (argc < 4)
+	{
+		cerr << "usage: " << argv[0] << " --batch <index file> <queries file|-> [AVL|HashMap|BTree|FlatHashMap|ART|PerfectHashMap] [threads] [clients] [k]" << endl;
+		return 1;
+	}
+	string indexType = "HashMap";
+	if (argc > 4)
+		indexType = argv[4];
+	int numberOfThreads = 0;
+	if (argc > 5)
+		numberOfThreads = atoi(argv[5]);
+	int numberOfClients = 1;
+	if (argc > 6)
+		numberOfClients = atoi(argv[6]);
+	int limit = 10;
+	if (argc > 7)
+		limit = atoi(argv[7]);
+
+	vector<string> queries;
+	string query;
+	if (string(argv[3]) == "-")
+	{
+		while (getline(cin, query))
+			if (query != "")
+				queries.push_back(query);
+	}
+	else
+	{
+		ifstream queryFile(argv[3]);
+		if (!queryFile.is_open())
+		{
+			cerr << "there was a problem opening the file " << argv[3] << endl;
+			return 1;
+		}
+		while (getline(queryFile, query))
+			if (query != "")
+				queries.push_back(query);
+	}
+
+	FileIndex* index = FileIndex::create(indexType);
+	if (index == NULL)
+	{
+		cerr << "A valid data structure was not selected" << endl;
+		return 1;
+	}
+	SecondaryParser secondaryParser(index);
+	secondaryParser.parseFile(argv[2]);
+
+	QueryServer* server = new QueryServer(index, numberOfThreads);
+	BatchRunner runner(server, numberOfClients, limit);
+	runner.run(queries);
+	runner.writeResults(cout);
+	runner.writeReport(cerr);
+
+	delete server;
+	delete index;
+	return 0;
+}
+
+QueryDaemon* runningDaemon = NULL;
+
+void stopDaemon(int)
+{
+	if (runningDaemon != NULL)
+		runningDaemon->stop();
+}
+
+/**
+	runDaemon loads the index once and answers queries from local clients until
+	it is interrupted. An address made of digits is a TCP port on 127.0.0.1,
+	anything else is the path of a unix domain socket.
+
+	usage: oUSE --daemon <index file> <socket path|port> [AVL|HashMap|BTree|FlatHashMap|ART|PerfectHashMap] [threads]
+**/
+int runDaemon(int argc, char* argv[])
+{
+	if (argc < 4)
+	{
+		cerr << "usage: " << argv[0] << " --daemon <index file> <socket path|port> [AVL|HashMap|BTree|FlatHashMap|ART|PerfectHashMap] [threads]" << endl;
+		return 1;
+	}
+	string indexType = "HashMap";
+	if (argc > 4)
+		indexType = argv[4];
+	int numberOfThreads = 0;
+	if (argc > 5)
+		numberOfThreads = atoi(argv[5]);
+
+	FileIndex* index = FileIndex::create(indexType);
+	if (index == NULL)
+	{
+		cerr << "A valid data structure was not selected" << endl;
+		return 1;
+	}
+	SecondaryParser secondaryParser(index);
+	secondaryParser.parseFile(argv[2]);
+
+	QueryServer* server = new QueryServer(index, numberOfThreads);
+	QueryDaemon* daemon = new QueryDaemon(server, argv[3]);
+	if (!daemon->start())
+	{
+		delete daemon;
+		delete server;
+		delete index;
+		return 1;
+	}
+
+	runningDaemon = daemon;
+	signal(SIGINT, stopDaemon);
+	signal(SIGTERM, stopDaemon);
+	cout << "Serving " << argv[2] << " on " << argv[3] << " with " << server->getNumberOfThreads() << " threads" << endl;
+	daemon->run();
+	runningDaemon = NULL;
+
+	delete daemon;
+	delete server;
+	delete index;
+	return 0;
 }
 
+/**
+	connectToDaemon starts the user interface as a thin client of a running daemon
+
+	usage: oUSE --connect <socket path|port>
+**/
+int connectToDaemon(int argc, char* argv[])
+{
+	if (argc < 3)
+	{
+		cerr << "usage: " << argv[0] << " --connect <socket path|port>" << endl;
+		return 1;
+	}
+	QueryClient* client = new QueryClient;
+	if (!client->connectTo(argv[2]))
+	{
+		delete client;
+		return 1;
+	}
+
+	UI* userInterface = new UI(client);
+	userInterface->startUI();
+	return 0;
+}